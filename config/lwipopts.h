@@ -30,4 +30,7 @@
 // This defaults to 4
 #define MQTT_REQ_MAX_IN_FLIGHT 8
 
+// This defaults to 256; the parking snapshot needs 7 bytes + 1 byte per 4 lots (1031 bytes for 4096 lots)
+#define MQTT_OUTPUT_RINGBUF_SIZE 1280
+
 #endif
\ No newline at end of file
@@ -3,4 +3,8 @@
 
 #include "mbedtls_config_examples_common.h"
 
+// Reconexões rápidas: o cliente guarda a sessão da última conexão (session ID) e aceita session tickets
+// do broker, de modo que a reconexão usa o handshake abreviado em vez de refazer a troca de chaves
+#define MBEDTLS_SSL_SESSION_TICKETS
+
 #endif
\ No newline at end of file
@@ -0,0 +1,510 @@
+// Microbenchmarks dos caminhos quentes do firmware, no host: cada operação roda isolada contra o
+// HAL simulado e é medida em tempo de CPU do host e em bytes enviados ao I2C, ao PIO e ao MQTT.
+// Uma saída CSV por linha: bench,op,lots,rate,iterations,ns_per_op,i2c_bytes_per_op,pio_bytes_per_op,mqtt_bytes_per_op
+// (rate é a taxa de mensagens em msg/s nos cenários de fluxo, 0 nos demais)
+
+#include <time.h>
+#include "mock_hal.h"
+#include "mock_ssd1306.h"
+
+// Logs do firmware descartados para não pesar na medição
+static inline int bench_discard(const char *format, ...)
+{
+    (void)format;
+    return 0;
+}
+#define DEBUG_printf bench_discard
+#define INFO_printf bench_discard
+#define WARN_printf bench_discard
+#define ERROR_printf bench_discard
+
+// O firmware entra na mesma unidade de compilação para alcançar as funções estáticas
+#define main parking_firmware_main
+#include "src/main.c"
+#undef main
+#include "lib/ssd1306/font.h"
+
+#define BENCH_ITERATIONS 2000       // Padrão; pode ser trocado pelo primeiro argumento
+#define BENCH_STREAM_MS 2000        // Duração (virtual) de cada cenário de fluxo
+#define BENCH_SETTLE_MS 5           // Tempo para o DMA e as confirmações terminarem entre operações
+
+static MQTT_CLIENT_DATA_T bench_state;
+static mock_ssd1306_t bench_oled; // Display no barramento, como no simulador
+static uint32_t bench_iterations = BENCH_ITERATIONS;
+
+typedef struct
+{
+    uint64_t ns;
+    mock_bus_stats_t bus;
+    uint64_t mqtt_bytes;
+} bench_sample_t;
+
+static uint64_t bench_now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + ts.tv_nsec;
+}
+
+// Gerador pseudoaleatório simples (xorshift), como no benchmark do parking_store
+static uint32_t bench_seed = 0x12345678;
+static inline uint32_t bench_random(void)
+{
+    bench_seed ^= bench_seed << 13;
+    bench_seed ^= bench_seed >> 17;
+    bench_seed ^= bench_seed << 5;
+    return bench_seed;
+}
+
+// Roda o contexto assíncrono (DMA, alarmes, confirmações MQTT) por ms de tempo virtual
+static void bench_settle(uint32_t ms)
+{
+    absolute_time_t until = make_timeout_time_ms(ms);
+    while (absolute_time_diff_us(get_absolute_time(), until) > 0)
+    {
+        cyw43_arch_poll();
+        cyw43_arch_wait_for_work_until(until);
+    }
+    cyw43_arch_poll();
+}
+
+// Publica o que ficou pendente de operações anteriores, para não ser contado na próxima medição
+static void bench_quiesce(void)
+{
+    uint32_t rtt_ms = 2 * mock_net_latency_us() / 1000 + 1;
+    do
+    {
+        publish_parking_status(&bench_state);
+        bench_settle(rtt_ms);
+    } while (parking_store_pending(&parking_store, PARKING_TRACK_PUBLISH) || snapshot_in_flight ||
+             publish_queue_depth(&bench_state.publish_queue) || batch_reply_count);
+    bench_settle(PUBLISH_COALESCE_MAX_MS);
+}
+
+// Começa uma medição: o tempo é somado só dentro de bench_time_start/stop,
+// os bytes contam tudo o que a operação provocou (inclusive o que sai depois por DMA)
+static void bench_begin(bench_sample_t *sample)
+{
+    bench_quiesce();
+    memset(sample, 0, sizeof(*sample));
+    mock_bus_stats_reset();
+    sample->mqtt_bytes = mock_mqtt_stats.publish_bytes;
+}
+
+static inline uint64_t bench_time_start(void)
+{
+    return bench_now_ns();
+}
+
+static inline void bench_time_stop(bench_sample_t *sample, uint64_t start)
+{
+    sample->ns += bench_now_ns() - start;
+}
+
+// Um NACK ou TX_ABRT troca o envio por janelas pelo caminho de aborto e zera a coluna do I2C: a medição não vale
+static void bench_report(const char *op, uint32_t rate, uint32_t iterations, bench_sample_t *sample)
+{
+    if (mock_bus_stats.i2c_nacks)
+        panic("bench: %s got %llu I2C NACKs", op, (unsigned long long)mock_bus_stats.i2c_nacks);
+
+    uint64_t mqtt_bytes = mock_mqtt_stats.publish_bytes - sample->mqtt_bytes;
+    uint64_t pio_bytes = mock_bus_stats.pio_words * WS2812B_PULL_BITS / 8;
+
+    printf("bench,%s,%u,%lu,%lu,%llu,%.1f,%.1f,%.1f\n", op, PARKING_LOT_SIZE, (unsigned long)rate,
+           (unsigned long)iterations, (unsigned long long)(sample->ns / iterations),
+           (double)mock_bus_stats.i2c_bytes / iterations, (double)pio_bytes / iterations,
+           (double)mqtt_bytes / iterations);
+}
+
+// Limpa o framebuffer: custo puro de CPU, sem barramento
+static void bench_ssd1306_fill(void)
+{
+    bench_sample_t sample;
+    bench_begin(&sample);
+    uint64_t start = bench_time_start();
+    for (uint32_t i = 0; i < bench_iterations; i++)
+        ssd1306_fill(&ssd, i & 1);
+    bench_time_stop(&sample, start);
+    bench_report("ssd1306_fill", 0, bench_iterations, &sample);
+}
+
+// Uma linha de status como as desenhadas por update_display
+static void bench_ssd1306_draw_string(void)
+{
+    bench_sample_t sample;
+    bench_begin(&sample);
+    uint64_t start = bench_time_start();
+    for (uint32_t i = 0; i < bench_iterations; i++)
+        ssd1306_draw_string(&ssd, "4: Reservada", 5, 25 + (i % 4) * 10);
+    bench_time_stop(&sample, start);
+    bench_report("ssd1306_draw_string", 0, bench_iterations, &sample);
+}
+
+// Caminho por pixel do driver antes dos atalhos por byte: referência para conferir e comparar
+static void reference_fill(ssd1306_t *ssd, bool value)
+{
+    for (uint8_t y = 0; y < ssd->height; ++y)
+        for (uint8_t x = 0; x < ssd->width; ++x)
+            ssd1306_pixel(ssd, x, y, value);
+}
+
+static void reference_rect(ssd1306_t *ssd, uint8_t top, uint8_t left, uint8_t width, uint8_t height, bool value, bool fill)
+{
+    for (uint8_t x = left; x < left + width; ++x)
+    {
+        ssd1306_pixel(ssd, x, top, value);
+        ssd1306_pixel(ssd, x, top + height - 1, value);
+    }
+    for (uint8_t y = top; y < top + height; ++y)
+    {
+        ssd1306_pixel(ssd, left, y, value);
+        ssd1306_pixel(ssd, left + width - 1, y, value);
+    }
+    if (fill)
+    {
+        for (uint8_t x = left + 1; x < left + width - 1; ++x)
+            for (uint8_t y = top + 1; y < top + height - 1; ++y)
+                ssd1306_pixel(ssd, x, y, value);
+    }
+}
+
+static void reference_draw_char(ssd1306_t *ssd, char c, uint8_t x, uint8_t y)
+{
+    uint16_t index = (c >= ' ' && c <= '~') ? (c - ' ') * 8 : 0;
+    for (uint8_t i = 0; i < 8; ++i)
+        for (uint8_t j = 0; j < 8; ++j)
+            ssd1306_pixel(ssd, x + i, y + j, font[index + i] & (1 << j));
+}
+
+static void reference_draw_string(ssd1306_t *ssd, const char *str, uint8_t x, uint8_t y)
+{
+    while (*str)
+    {
+        reference_draw_char(ssd, *str++, x, y);
+        x += 8;
+        if (x + 8 >= ssd->width)
+        {
+            x = 0;
+            y += 8;
+        }
+        if (y + 8 >= ssd->height)
+            break;
+    }
+}
+
+// Aplica a mesma operação aleatória pelos dois caminhos, a partir do mesmo framebuffer
+static bool ssd1306_compare_once(uint8_t op, uint32_t a, uint32_t b, const uint8_t *start, uint8_t *expected)
+{
+    uint8_t x = a % ssd.width, y = (a >> 8) % ssd.height;
+    uint8_t w = 1 + b % (ssd.width - x), h = 1 + (b >> 8) % (ssd.height - y);
+    bool value = b & 0x10000;
+    char c = (char)(b >> 17);
+
+    for (int pass = 0; pass < 2; pass++)
+    {
+        memcpy(ssd.ram_buffer, start, ssd.bufsize);
+        switch (op)
+        {
+        case 0:
+            pass ? ssd1306_draw_char(&ssd, c, x, y) : reference_draw_char(&ssd, c, x, y);
+            break;
+        case 1:
+            pass ? ssd1306_rect(&ssd, y, x, w, h, value, true) : reference_rect(&ssd, y, x, w, h, value, true);
+            break;
+        case 2:
+            pass ? ssd1306_rect(&ssd, y, x, w, h, value, false) : reference_rect(&ssd, y, x, w, h, value, false);
+            break;
+        case 3:
+            pass ? ssd1306_hline(&ssd, x, x + w - 1, y, value) : reference_rect(&ssd, y, x, w, 1, value, true);
+            break;
+        case 4:
+            pass ? ssd1306_vline(&ssd, x, y, y + h - 1, value) : reference_rect(&ssd, y, x, 1, h, value, true);
+            break;
+        default:
+            pass ? ssd1306_fill(&ssd, value) : reference_fill(&ssd, value);
+            break;
+        }
+        if (!pass)
+            memcpy(expected, ssd.ram_buffer, ssd.bufsize);
+    }
+    return memcmp(expected, ssd.ram_buffer, ssd.bufsize) == 0;
+}
+
+// Confere que os atalhos por byte (cópia de colunas, deslocamento entre páginas, máscaras por página)
+// produzem o mesmo framebuffer que o caminho por pixel, em posições e conteúdos aleatórios
+static void bench_ssd1306_equivalence(void)
+{
+    static uint8_t saved[WIDTH * SSD1306_MAX_PAGES + 1];
+    static uint8_t start[WIDTH * SSD1306_MAX_PAGES + 1];
+    static uint8_t expected[WIDTH * SSD1306_MAX_PAGES + 1];
+
+    memcpy(saved, ssd.ram_buffer, ssd.bufsize);
+    for (uint32_t i = 0; i < bench_iterations; i++)
+    {
+        for (size_t j = 1; j < ssd.bufsize; j++)
+            start[j] = (uint8_t)bench_random();
+        uint8_t op = i % 6;
+        uint32_t a = bench_random(), b = bench_random();
+        if (!ssd1306_compare_once(op, a, b, start, expected))
+            panic("bench: ssd1306 op %u (0x%08lx, 0x%08lx) differs from the pixel path", op, (unsigned long)a,
+                  (unsigned long)b);
+    }
+    // O display continua mostrando o conteúdo anterior: a cópia do que foi enviado descarta as marcas
+    memcpy(ssd.ram_buffer, saved, ssd.bufsize);
+}
+
+// A sequência de desenho de update_display (tela limpa e 6 linhas), pelo caminho por pixel e pelo atual
+static void bench_ssd1306_render(bool reference)
+{
+    static const char *lines[] = {"Estacionamento", "Livres: 3", "1: Livre", "2: Ocupada", "3: Reservada", "4: Livre"};
+    bench_sample_t sample;
+    bench_begin(&sample);
+    uint64_t start = bench_time_start();
+    for (uint32_t i = 0; i < bench_iterations; i++)
+    {
+        if (reference)
+            reference_fill(&ssd, false);
+        else
+            ssd1306_fill(&ssd, false);
+        for (uint8_t line = 0; line < count_of(lines); line++)
+        {
+            uint8_t y = line ? 5 + line * 10 : 0;
+            if (reference)
+                reference_draw_string(&ssd, lines[line], 5, y);
+            else
+                ssd1306_draw_string(&ssd, lines[line], 5, y);
+        }
+    }
+    bench_time_stop(&sample, start);
+    bench_report(reference ? "ssd1306_render_pixel" : "ssd1306_render", 0, bench_iterations, &sample);
+}
+
+// Quadro inteiro da matriz; a espera pelo fim da transmissão fica fora do tempo medido
+static void bench_ws2812b_write(void)
+{
+    bench_sample_t sample;
+    bench_begin(&sample);
+    for (uint32_t i = 0; i < bench_iterations; i++)
+    {
+        uint64_t start = bench_time_start();
+        ws2812b_write();
+        bench_time_stop(&sample, start);
+        bench_settle(1);
+    }
+    bench_report("ws2812b_write", 0, bench_iterations, &sample);
+}
+
+// Uma vaga muda de status e todas as saídas são atualizadas
+static void bench_update_outputs(void)
+{
+    bench_sample_t sample;
+    bench_begin(&sample);
+    for (uint32_t i = 0; i < bench_iterations; i++)
+    {
+        parking_store_set(&parking_store, bench_random() % PARKING_LOT_SIZE, PARKING_FREE + i % 3);
+        uint64_t start = bench_time_start();
+        update_outputs();
+        bench_time_stop(&sample, start);
+        bench_settle(BENCH_SETTLE_MS);
+    }
+    bench_report("update_outputs", 0, bench_iterations, &sample);
+
+    // Sem mudanças: só o custo de conferir o bitmap e redesenhar o display
+    bench_begin(&sample);
+    for (uint32_t i = 0; i < bench_iterations; i++)
+    {
+        uint64_t start = bench_time_start();
+        update_outputs();
+        bench_time_stop(&sample, start);
+        bench_settle(BENCH_SETTLE_MS);
+    }
+    bench_report("update_outputs_unchanged", 0, bench_iterations, &sample);
+}
+
+// Publicação com uma vaga alterada e com todas alteradas (ressincronização)
+static void bench_publish_parking_status(void)
+{
+    uint32_t rtt_ms = 2 * mock_net_latency_us() / 1000 + 1;
+    bench_sample_t sample;
+
+    bench_begin(&sample);
+    for (uint32_t i = 0; i < bench_iterations; i++)
+    {
+        parking_store_set(&parking_store, bench_random() % PARKING_LOT_SIZE, PARKING_FREE + i % 3);
+        uint64_t start = bench_time_start();
+        publish_parking_status(&bench_state);
+        bench_time_stop(&sample, start);
+        bench_settle(rtt_ms);
+    }
+    bench_report("publish_parking_status_one", 0, bench_iterations, &sample);
+
+    // Todas as vagas: o envio continua a cada confirmação, por isso o contexto roda até esvaziar
+    uint32_t rounds = MAX(bench_iterations / 100, 1);
+    bench_begin(&sample);
+    for (uint32_t i = 0; i < rounds; i++)
+    {
+        request_full_resync();
+        do
+        {
+            uint64_t start = bench_time_start();
+            publish_parking_status(&bench_state);
+            bench_time_stop(&sample, start);
+            bench_settle(rtt_ms);
+        } while (parking_store_pending(&parking_store, PARKING_TRACK_PUBLISH) || snapshot_in_flight);
+    }
+    bench_report("publish_parking_status_all", 0, rounds, &sample);
+}
+
+// Entrega uma mensagem como o cliente lwIP: tópico e depois o payload em um fragmento
+static void bench_deliver(const char *topic, const uint8_t *payload, uint16_t len)
+{
+    mqtt_incoming_publish_cb(&bench_state, topic, len);
+    mqtt_incoming_data_cb(&bench_state, payload, len, MQTT_DATA_FLAG_LAST);
+}
+
+// Roteamento do tópico recebido: reserva de vaga ocupada (o tratador só confere e descarta)
+// e tópico sem rota
+static void bench_topic_dispatch(void)
+{
+    char topic[MQTT_TOPIC_LEN];
+    bench_sample_t sample;
+
+    for (uint16_t lot = 0; lot < PARKING_LOT_SIZE; lot++)
+        parking_store_set(&parking_store, lot, PARKING_OCCUPIED);
+    update_outputs();
+    bench_settle(BENCH_SETTLE_MS);
+
+    bench_begin(&sample);
+    for (uint32_t i = 0; i < bench_iterations; i++)
+    {
+        snprintf(topic, sizeof(topic), "/parking/%lu/reservation", (unsigned long)(bench_random() % PARKING_LOT_SIZE + 1));
+        uint64_t start = bench_time_start();
+        bench_deliver(topic, NULL, 0);
+        bench_time_stop(&sample, start);
+    }
+    bench_report("topic_dispatch_reservation", 0, bench_iterations, &sample);
+
+    bench_begin(&sample);
+    uint64_t start = bench_time_start();
+    for (uint32_t i = 0; i < bench_iterations; i++)
+        bench_deliver("/parking/status/unknown", NULL, 0);
+    bench_time_stop(&sample, start);
+    bench_report("topic_dispatch_unrouted", 0, bench_iterations, &sample);
+
+    for (uint16_t lot = 0; lot < PARKING_LOT_SIZE; lot++)
+        parking_store_set(&parking_store, lot, PARKING_FREE);
+    update_outputs();
+    bench_settle(BENCH_SETTLE_MS);
+}
+
+// Fluxo de comandos em lote de um item (reserva e liberação alternadas) a uma taxa fixa:
+// mede o processamento da mensagem e o tráfego resultante, incluindo o agrupamento das publicações
+static void bench_batch_stream(uint32_t rate)
+{
+    uint32_t messages = MAX(rate * BENCH_STREAM_MS / 1000, 1);
+    uint32_t interval_us = 1000000 / rate;
+    uint8_t payload[7] = {PARKING_BATCH_LIST};
+    bench_sample_t sample;
+
+    bench_begin(&sample);
+    for (uint32_t i = 0; i < messages; i++)
+    {
+        uint16_t lot = (i / 2) % PARKING_LOT_SIZE + 1;
+        uint16_t duration_s = (i & 1) ? 0 : 30; // Reserva e em seguida libera a mesma vaga
+        payload[1] = i >> 8;
+        payload[2] = i;
+        payload[3] = lot >> 8;
+        payload[4] = lot;
+        payload[5] = duration_s >> 8;
+        payload[6] = duration_s;
+
+        uint64_t start = bench_time_start();
+        bench_deliver("/parking/batch", payload, sizeof(payload));
+        bench_time_stop(&sample, start);
+
+        absolute_time_t next = delayed_by_us(get_absolute_time(), interval_us);
+        while (absolute_time_diff_us(get_absolute_time(), next) > 0)
+        {
+            cyw43_arch_poll();
+            cyw43_arch_wait_for_work_until(next);
+        }
+    }
+    bench_settle(PUBLISH_COALESCE_MAX_MS + 100); // Última janela de agrupamento e confirmações
+    bench_report("batch_stream", rate, messages, &sample);
+}
+
+// Transferência do display abortada (TX_ABRT): o benchmark para em vez de medir o reenvio
+static void bench_display_done(void *arg, bool ok)
+{
+    if (!ok)
+        panic("bench: display transfer aborted");
+    display_flush_done(arg, ok);
+}
+
+// Mesmo estado inicial do firmware, com o cliente MQTT conectado ao broker simulado
+static void bench_init(void)
+{
+    mock_time_reset();
+    mock_rand_seed(1);
+    mock_ssd1306_attach(&bench_oled, SSD1306_I2C_PORT, SSD1306_ADDRESS);
+    stdio_init_all();
+    init_parking_lots();
+    init_leds();
+    ws2812b_init(LED_MATRIX_PIN);
+    init_display(&ssd);
+    init_buzzer(BUZZER_A_PIN, 4.0);
+    cyw43_arch_init();
+
+    async_context_add_when_pending_worker(cyw43_arch_async_context(), &display_flush_worker);
+    ssd1306_set_done_callback(&ssd, bench_display_done, NULL);
+    if (!topic_router_init(&topic_router, topic_routes, count_of(topic_routes)))
+        panic("Topic router too small");
+    static uint8_t payload_buffer[MQTT_PAYLOAD_MAX_LEN];
+    payload_assembler_init(&bench_state.payload, payload_buffer, sizeof(payload_buffer));
+    static parking_batch_item_t batch_items[PARKING_BATCH_MAX_ITEMS];
+    parking_batch_init(&batch, batch_items, PARKING_BATCH_MAX_ITEMS, PARKING_LOT_SIZE);
+
+    bench_state.mqtt_client_info.client_id = "bench";
+    bench_state.mqtt_client_info.keep_alive = MQTT_KEEP_ALIVE_S;
+    bench_state.disconnected_at = nil_time;
+    publish_coalesce_worker.user_data = &bench_state;
+    status_publish_worker.user_data = &bench_state;
+    async_context_add_when_pending_worker(cyw43_arch_async_context(), &status_publish_worker);
+
+    reconnect_worker.user_data = &bench_state;
+    bench_state.backoff_ms = MQTT_RECONNECT_MIN_MS;
+
+    update_led_matrix();
+    update_outputs();
+    cyw43_arch_enable_sta_mode();
+    if (cyw43_arch_wifi_connect_timeout_ms(WIFI_SSID, WIFI_PASSWORD, CYW43_AUTH_WPA2_AES_PSK, 30000))
+        panic("bench: Wi-Fi did not connect");
+    start_client(&bench_state);
+    bench_settle(1000);
+    if (!mqtt_client_is_connected(bench_state.mqtt_client_inst))
+        panic("bench: MQTT client did not connect");
+    if (mock_bus_stats.i2c_nacks)
+        panic("bench: display did not answer on I2C");
+}
+
+int main(int argc, char **argv)
+{
+    static const uint32_t rates[] = {10, 100, 1000};
+
+    if (argc > 1)
+        bench_iterations = MAX(strtoul(argv[1], NULL, 0), 1);
+
+    bench_init();
+    bench_ssd1306_fill();
+    bench_ssd1306_draw_string();
+    bench_ssd1306_equivalence();
+    bench_ssd1306_render(true);
+    bench_ssd1306_render(false);
+    bench_ws2812b_write();
+    bench_update_outputs();
+    bench_publish_parking_status();
+    bench_topic_dispatch();
+    for (size_t i = 0; i < count_of(rates); i++)
+        bench_batch_stream(rates[i]);
+    return 0;
+}
@@ -0,0 +1,10 @@
+#ifndef CREDENTIAL_CONFIG_H
+#define CREDENTIAL_CONFIG_H
+
+// Credenciais da build de host: a rede e o broker são simulados (mock/mock_net.c, mock/mock_mqtt.c)
+#define WIFI_SSID "host"
+#define WIFI_PASSWORD "host"
+
+#define MQTT_SERVER "broker.host"
+
+#endif // CREDENTIAL_CONFIG_H
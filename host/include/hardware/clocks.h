@@ -0,0 +1,16 @@
+#ifndef HOST_HARDWARE_CLOCKS_H
+#define HOST_HARDWARE_CLOCKS_H
+
+#include "pico/stdlib.h"
+
+enum clock_index
+{
+    clk_gpout0 = 0,
+    clk_ref = 4,
+    clk_sys = 5,
+    clk_peri = 6,
+};
+
+static inline uint32_t clock_get_hz(enum clock_index clk_index) { return clk_index == clk_sys ? 125000000u : 48000000u; }
+
+#endif // HOST_HARDWARE_CLOCKS_H
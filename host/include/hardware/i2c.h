@@ -0,0 +1,42 @@
+#ifndef HOST_HARDWARE_I2C_H
+#define HOST_HARDWARE_I2C_H
+
+#include "pico/stdlib.h"
+
+// Registros usados pelo envio por DMA do ssd1306 (o mock só guarda os valores)
+typedef struct
+{
+    volatile uint32_t enable;
+    volatile uint32_t tar;
+    volatile uint32_t data_cmd;
+    volatile uint32_t intr_mask;
+    volatile uint32_t intr_stat;
+    volatile uint32_t raw_intr_stat;
+    volatile uint32_t clr_stop_det;
+    volatile uint32_t clr_tx_abrt;
+} i2c_hw_t;
+
+typedef struct i2c_inst
+{
+    i2c_hw_t *hw;
+    uint baudrate;
+} i2c_inst_t;
+
+extern i2c_inst_t mock_i2c_inst[2];
+#define i2c0 (&mock_i2c_inst[0])
+#define i2c1 (&mock_i2c_inst[1])
+
+#define I2C_IC_DATA_CMD_STOP_BITS 0x00000200u
+#define I2C_IC_DATA_CMD_RESTART_BITS 0x00000400u
+#define I2C_IC_INTR_MASK_M_TX_ABRT_BITS 0x00000040u
+#define I2C_IC_INTR_MASK_M_STOP_DET_BITS 0x00000200u
+#define I2C_IC_INTR_STAT_R_TX_ABRT_BITS 0x00000040u
+
+uint i2c_init(i2c_inst_t *i2c, uint baudrate);
+int i2c_write_blocking(i2c_inst_t *i2c, uint8_t addr, const uint8_t *src, size_t len, bool nostop);
+
+static inline uint i2c_hw_index(i2c_inst_t *i2c) { return (uint)(i2c - mock_i2c_inst); }
+static inline i2c_hw_t *i2c_get_hw(i2c_inst_t *i2c) { return i2c->hw; }
+static inline uint i2c_get_dreq(i2c_inst_t *i2c, bool is_tx) { return 32 + 2 * i2c_hw_index(i2c) + (is_tx ? 0 : 1); }
+
+#endif // HOST_HARDWARE_I2C_H
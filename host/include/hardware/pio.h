@@ -0,0 +1,52 @@
+#ifndef HOST_HARDWARE_PIO_H
+#define HOST_HARDWARE_PIO_H
+
+#include "pico/stdlib.h"
+
+#define NUM_PIO_STATE_MACHINES 4
+
+typedef struct
+{
+    volatile uint32_t txf[NUM_PIO_STATE_MACHINES];
+} pio_hw_t;
+typedef pio_hw_t *PIO;
+
+extern pio_hw_t mock_pio_hw[2];
+#define pio0 (&mock_pio_hw[0])
+#define pio1 (&mock_pio_hw[1])
+
+typedef struct
+{
+    const uint16_t *instructions;
+    uint8_t length;
+    int8_t origin;
+} pio_program_t;
+
+typedef struct
+{
+    float clkdiv;
+    uint out_bits;
+} pio_sm_config;
+
+enum pio_fifo_join
+{
+    PIO_FIFO_JOIN_NONE = 0,
+    PIO_FIFO_JOIN_TX = 1,
+    PIO_FIFO_JOIN_RX = 2,
+};
+
+uint pio_add_program(PIO pio, const pio_program_t *program);
+int pio_claim_unused_sm(PIO pio, bool required);
+void pio_gpio_init(PIO pio, uint pin);
+int pio_sm_set_consecutive_pindirs(PIO pio, uint sm, uint pin_base, uint pin_count, bool is_out);
+int pio_sm_init(PIO pio, uint sm, uint initial_pc, const pio_sm_config *config);
+void pio_sm_set_enabled(PIO pio, uint sm, bool enabled);
+void pio_sm_put_blocking(PIO pio, uint sm, uint32_t data);
+
+static inline uint pio_get_index(PIO pio) { return (uint)(pio - mock_pio_hw); }
+static inline uint pio_get_dreq(PIO pio, uint sm, bool is_tx) { return pio_get_index(pio) * 8 + sm + (is_tx ? 0 : 4); }
+
+// Tempo de saída de uma palavra da FIFO: ajustado pelo programa (ver ws2812b.pio.h do host)
+void mock_pio_set_word_us(PIO pio, uint sm, float word_us);
+
+#endif // HOST_HARDWARE_PIO_H
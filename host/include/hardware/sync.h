@@ -0,0 +1,12 @@
+#ifndef HOST_HARDWARE_SYNC_H
+#define HOST_HARDWARE_SYNC_H
+
+#include "pico/stdlib.h"
+
+// Um único núcleo e interrupções síncronas ao relógio virtual: basta a barreira do compilador
+static inline uint32_t save_and_disable_interrupts(void) { return 0; }
+static inline void restore_interrupts(uint32_t status) { (void)status; }
+static inline void __dmb(void) { __atomic_thread_fence(__ATOMIC_SEQ_CST); }
+static inline void __wfi(void) { mock_time_idle(); }
+
+#endif // HOST_HARDWARE_SYNC_H
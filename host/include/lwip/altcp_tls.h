@@ -0,0 +1,17 @@
+#ifndef HOST_LWIP_ALTCP_TLS_H
+#define HOST_LWIP_ALTCP_TLS_H
+
+// A build de host não usa TLS (MQTT_CERT_INC indefinido): só as declarações referenciadas
+
+#include "lwip/err.h"
+
+struct altcp_pcb;
+struct altcp_tls_config;
+struct altcp_tls_session;
+
+struct altcp_tls_config *altcp_tls_create_config_client(const u8_t *cert, size_t cert_len);
+struct altcp_tls_config *altcp_tls_create_config_client_2wayauth(const u8_t *ca, size_t ca_len, const u8_t *privkey,
+                                                                  size_t privkey_len, const u8_t *privkey_pass,
+                                                                  size_t privkey_pass_len, const u8_t *cert, size_t cert_len);
+
+#endif // HOST_LWIP_ALTCP_TLS_H
@@ -0,0 +1,35 @@
+#ifndef HOST_LWIP_APPS_MQTT_PRIV_H
+#define HOST_LWIP_APPS_MQTT_PRIV_H
+
+#include "pico/stdlib.h"
+#include "lwip/apps/mqtt.h"
+
+#define MQTT_HOST_MAX_SUBSCRIPTIONS 16
+#define MQTT_HOST_TOPIC_LEN 128
+
+// Requisição aguardando o envio (QoS 0) ou a confirmação do broker simulado (QoS 1 e assinaturas)
+struct mqtt_request_t
+{
+    bool used;
+    mqtt_request_cb_t cb;
+    void *arg;
+    u16_t ringbuf_bytes; // Espaço ocupado no buffer de saída até o envio
+};
+
+// Estado do cliente simulado; como no lwIP, mqtt_client_connect zera a estrutura
+struct mqtt_client_s
+{
+    u8_t conn_state; // 0 = desconectado, 1 = conectando, 2 = conectado
+    mqtt_connection_cb_t connect_cb;
+    void *connect_arg;
+    mqtt_incoming_publish_cb_t pub_cb;
+    mqtt_incoming_data_cb_t data_cb;
+    void *inpub_arg;
+    struct mqtt_request_t req_list[MQTT_REQ_MAX_IN_FLIGHT];
+    u16_t ringbuf_used;
+    uint32_t session; // Muda a cada conexão: descarta eventos agendados para uma conexão anterior
+    char subscriptions[MQTT_HOST_MAX_SUBSCRIPTIONS][MQTT_HOST_TOPIC_LEN];
+    struct altcp_pcb *conn;
+};
+
+#endif // HOST_LWIP_APPS_MQTT_PRIV_H
@@ -0,0 +1,13 @@
+#ifndef HOST_LWIP_IP_ADDR_H
+#define HOST_LWIP_IP_ADDR_H
+
+#include "lwip/err.h"
+
+typedef struct ip4_addr
+{
+    u32_t addr;
+} ip_addr_t;
+
+char *ipaddr_ntoa(const ip_addr_t *addr);
+
+#endif // HOST_LWIP_IP_ADDR_H
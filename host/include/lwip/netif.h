@@ -0,0 +1,14 @@
+#ifndef HOST_LWIP_NETIF_H
+#define HOST_LWIP_NETIF_H
+
+#include "lwip/ip_addr.h"
+
+struct netif
+{
+    struct netif *next;
+    ip_addr_t ip_addr;
+};
+
+extern struct netif *netif_list;
+
+#endif // HOST_LWIP_NETIF_H
@@ -0,0 +1,9 @@
+#ifndef HOST_PICO_RAND_H
+#define HOST_PICO_RAND_H
+
+#include "pico/stdlib.h"
+
+uint32_t get_rand_32(void); // Sequência determinística (reprodutível entre execuções)
+uint64_t get_rand_64(void);
+
+#endif // HOST_PICO_RAND_H
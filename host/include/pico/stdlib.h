@@ -0,0 +1,76 @@
+#ifndef HOST_PICO_STDLIB_H
+#define HOST_PICO_STDLIB_H
+
+// Subconjunto do pico/stdlib.h para a build de host: o tempo é virtual e avança só quando o firmware
+// espera (sleep, busy_wait, tight_loop) ou quando o simulador manda (mock_time_advance_us)
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <assert.h>
+
+typedef unsigned int uint;
+typedef uint64_t absolute_time_t; // Microssegundos desde o boot
+
+#define __unused __attribute__((unused))
+#define __not_in_flash_func(f) f
+#define count_of(a) (sizeof(a) / sizeof((a)[0]))
+#define PICO_OK 0
+#define PICO_ERROR_GENERIC (-1)
+#ifndef MIN
+#define MIN(a, b) ((a) < (b) ? (a) : (b))
+#endif
+#ifndef MAX
+#define MAX(a, b) ((a) > (b) ? (a) : (b))
+#endif
+
+#define panic(...)                                   \
+    do                                               \
+    {                                                \
+        fprintf(stderr, "*** PANIC ***\n" __VA_ARGS__); \
+        abort();                                     \
+    } while (0)
+
+// Relógio virtual (mock/mock_time.c)
+uint64_t mock_time_now_us(void);
+void mock_time_advance_us(uint64_t us); // Avança o relógio disparando os eventos vencidos (alarmes, DMA)
+void mock_time_idle(void);              // Espera ativa: salta até o próximo evento
+
+#define nil_time ((absolute_time_t)0)
+#define at_the_end_of_time ((absolute_time_t)INT64_MAX)
+
+static inline absolute_time_t get_absolute_time(void) { return mock_time_now_us(); }
+static inline uint64_t to_us_since_boot(absolute_time_t t) { return t; }
+static inline uint32_t to_ms_since_boot(absolute_time_t t) { return (uint32_t)(t / 1000); }
+static inline absolute_time_t delayed_by_us(absolute_time_t t, uint64_t us) { return t + us; }
+static inline absolute_time_t delayed_by_ms(absolute_time_t t, uint32_t ms) { return t + ms * 1000ull; }
+static inline absolute_time_t make_timeout_time_us(uint64_t us) { return delayed_by_us(get_absolute_time(), us); }
+static inline absolute_time_t make_timeout_time_ms(uint32_t ms) { return delayed_by_ms(get_absolute_time(), ms); }
+static inline int64_t absolute_time_diff_us(absolute_time_t from, absolute_time_t to) { return (int64_t)(to - from); }
+static inline bool is_nil_time(absolute_time_t t) { return t == nil_time; }
+static inline uint32_t time_us_32(void) { return (uint32_t)mock_time_now_us(); }
+static inline uint64_t time_us_64(void) { return mock_time_now_us(); }
+
+static inline void sleep_us(uint64_t us) { mock_time_advance_us(us); }
+static inline void sleep_ms(uint32_t ms) { mock_time_advance_us(ms * 1000ull); }
+static inline void busy_wait_us(uint64_t us) { mock_time_advance_us(us); }
+static inline void busy_wait_ms(uint32_t ms) { mock_time_advance_us(ms * 1000ull); }
+static inline void tight_loop_contents(void) { mock_time_idle(); }
+
+// Alarmes: disparam como interrupções quando o relógio virtual passa do prazo
+typedef int32_t alarm_id_t;
+typedef int64_t (*alarm_callback_t)(alarm_id_t id, void *user_data);
+alarm_id_t add_alarm_at(absolute_time_t time, alarm_callback_t callback, void *user_data, bool fire_if_past);
+alarm_id_t add_alarm_in_us(uint64_t us, alarm_callback_t callback, void *user_data, bool fire_if_past);
+alarm_id_t add_alarm_in_ms(uint32_t ms, alarm_callback_t callback, void *user_data, bool fire_if_past);
+bool cancel_alarm(alarm_id_t alarm_id);
+
+static inline bool stdio_init_all(void) { return true; }
+
+#include "hardware/gpio.h"
+
+#endif // HOST_PICO_STDLIB_H
@@ -0,0 +1,8 @@
+#ifndef HOST_PICO_UNIQUE_ID_H
+#define HOST_PICO_UNIQUE_ID_H
+
+#include "pico/stdlib.h"
+
+void pico_get_unique_board_id_string(char *id_out, uint len);
+
+#endif // HOST_PICO_UNIQUE_ID_H
@@ -0,0 +1,26 @@
+#ifndef HOST_WS2812B_PIO_H
+#define HOST_WS2812B_PIO_H
+
+// Substitui o cabeçalho gerado por pioasm: no host o programa só define quanto tempo cada palavra
+// leva para sair da FIFO (pull_bits bits a freq bits por segundo)
+
+#include "hardware/pio.h"
+
+static const uint16_t led_matrix_program_instructions[] = {0x6221, 0x1123, 0x1400, 0xa442};
+static const pio_program_t led_matrix_program = {
+    .instructions = led_matrix_program_instructions,
+    .length = 4,
+    .origin = -1,
+};
+
+static inline void led_matrix_program_init(PIO pio, uint sm, uint offset, uint pin, float freq, uint pull_bits)
+{
+    pio_gpio_init(pio, pin);
+    pio_sm_set_consecutive_pindirs(pio, sm, pin, 1, true);
+    pio_sm_config c = {.clkdiv = 1.0f, .out_bits = pull_bits};
+    pio_sm_init(pio, sm, offset, &c);
+    mock_pio_set_word_us(pio, sm, pull_bits * 1e6f / freq);
+    pio_sm_set_enabled(pio, sm, true);
+}
+
+#endif // HOST_WS2812B_PIO_H
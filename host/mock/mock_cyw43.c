@@ -0,0 +1,317 @@
+#include "mock_hal.h"
+#include "pico/cyw43_arch.h"
+#include "pico/rand.h"
+#include "pico/unique_id.h"
+#include "lwip/dns.h"
+#include "lwip/netif.h"
+
+// Contexto assíncrono, Wi-Fi e DNS simulados. Os workers rodam só dentro de cyw43_arch_poll e
+// cyw43_arch_wait_for_work_until, como no modo "background" do SDK visto pelo laço principal
+
+cyw43_t cyw43_state;
+
+static async_context_t context;
+static bool link_allowed = true;
+static bool dns_resolves = true;
+static uint32_t latency_us = 5000;
+static uint32_t rand_state = 0x2545F491;
+
+static struct netif host_netif = {.next = NULL, .ip_addr = {.addr = 0x0200000a}}; // 10.0.0.2
+struct netif *netif_list = &host_netif;
+
+// Workers do contexto
+
+static bool list_remove_at_time(async_at_time_worker_t *worker)
+{
+    for (async_at_time_worker_t **p = &context.at_time_list; *p; p = &(*p)->next)
+    {
+        if (*p == worker)
+        {
+            *p = worker->next;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool async_context_add_at_time_worker(async_context_t *ctx, async_at_time_worker_t *worker)
+{
+    list_remove_at_time(worker);
+    worker->next = ctx->at_time_list;
+    ctx->at_time_list = worker;
+    return true;
+}
+
+bool async_context_add_at_time_worker_at(async_context_t *ctx, async_at_time_worker_t *worker, absolute_time_t at)
+{
+    worker->next_time = at;
+    return async_context_add_at_time_worker(ctx, worker);
+}
+
+bool async_context_add_at_time_worker_in_ms(async_context_t *ctx, async_at_time_worker_t *worker, uint32_t ms)
+{
+    return async_context_add_at_time_worker_at(ctx, worker, make_timeout_time_ms(ms));
+}
+
+bool async_context_remove_at_time_worker(async_context_t *ctx, async_at_time_worker_t *worker)
+{
+    (void)ctx;
+    return list_remove_at_time(worker);
+}
+
+bool async_context_add_when_pending_worker(async_context_t *ctx, async_when_pending_worker_t *worker)
+{
+    for (async_when_pending_worker_t *w = ctx->when_pending_list; w; w = w->next)
+    {
+        if (w == worker)
+            return false;
+    }
+    worker->next = ctx->when_pending_list;
+    ctx->when_pending_list = worker;
+    return true;
+}
+
+bool async_context_remove_when_pending_worker(async_context_t *ctx, async_when_pending_worker_t *worker)
+{
+    for (async_when_pending_worker_t **p = &ctx->when_pending_list; *p; p = &(*p)->next)
+    {
+        if (*p == worker)
+        {
+            *p = worker->next;
+            return true;
+        }
+    }
+    return false;
+}
+
+void async_context_set_work_pending(async_context_t *ctx, async_when_pending_worker_t *worker)
+{
+    (void)ctx;
+    worker->work_pending = true;
+}
+
+// Próximo at_time worker vencido (o mais antigo primeiro)
+static async_at_time_worker_t *due_at_time_worker(void)
+{
+    async_at_time_worker_t *due = NULL;
+    for (async_at_time_worker_t *w = context.at_time_list; w; w = w->next)
+    {
+        if (w->next_time <= get_absolute_time() && (!due || w->next_time < due->next_time))
+            due = w;
+    }
+    return due;
+}
+
+static bool work_is_due(void)
+{
+    absolute_time_t at;
+    if (due_at_time_worker() || (mock_context_next_event(&at) && at <= get_absolute_time()))
+        return true;
+    for (async_when_pending_worker_t *w = context.when_pending_list; w; w = w->next)
+    {
+        if (w->work_pending)
+            return true;
+    }
+    return false;
+}
+
+async_context_t *cyw43_arch_async_context(void)
+{
+    return &context;
+}
+
+// Executa tudo o que estiver vencido: eventos de rede, workers pendentes e workers com prazo
+void cyw43_arch_poll(void)
+{
+    bool ran;
+    do
+    {
+        ran = mock_context_run_due();
+
+        for (async_when_pending_worker_t *w = context.when_pending_list; w; w = w->next)
+        {
+            if (w->work_pending)
+            {
+                w->work_pending = false;
+                w->do_work(&context, w);
+                ran = true;
+            }
+        }
+
+        async_at_time_worker_t *worker = due_at_time_worker();
+        if (worker)
+        {
+            list_remove_at_time(worker); // Como no SDK: o worker sai da lista antes de rodar
+            worker->do_work(&context, worker);
+            ran = true;
+        }
+    } while (ran);
+}
+
+// Avança o relógio até o primeiro que vencer: prazo pedido, worker, evento de rede ou interrupção
+void cyw43_arch_wait_for_work_until(absolute_time_t until)
+{
+    if (work_is_due())
+        return;
+
+    absolute_time_t target = until, at;
+    for (async_at_time_worker_t *w = context.at_time_list; w; w = w->next)
+        target = MIN(target, w->next_time);
+    if (mock_context_next_event(&at))
+        target = MIN(target, at);
+    if (mock_time_next_event(&at))
+        target = MIN(target, at);
+
+    if (target > get_absolute_time())
+        mock_time_advance_us(target - get_absolute_time());
+}
+
+// Wi-Fi
+
+int cyw43_arch_init(void)
+{
+    cyw43_state.link_status = CYW43_LINK_DOWN;
+    return 0;
+}
+
+void cyw43_arch_deinit(void)
+{
+}
+
+void cyw43_arch_enable_sta_mode(void)
+{
+}
+
+void cyw43_arch_gpio_put(uint wl_gpio, bool value)
+{
+    (void)wl_gpio;
+    (void)value;
+}
+
+static void link_up(void *arg)
+{
+    (void)arg;
+    if (link_allowed)
+        cyw43_state.link_status = CYW43_LINK_UP;
+}
+
+int cyw43_arch_wifi_connect_timeout_ms(const char *ssid, const char *pw, uint32_t auth, uint32_t timeout)
+{
+    (void)ssid;
+    (void)pw;
+    (void)auth;
+    if (!link_allowed)
+    {
+        mock_time_advance_us(timeout * 1000ull);
+        return -1;
+    }
+    mock_time_advance_us(4 * latency_us);
+    cyw43_state.link_status = CYW43_LINK_UP;
+    return 0;
+}
+
+int cyw43_arch_wifi_connect_async(const char *ssid, const char *pw, uint32_t auth)
+{
+    (void)ssid;
+    (void)pw;
+    (void)auth;
+    cyw43_state.link_status = CYW43_LINK_JOIN;
+    mock_context_schedule(make_timeout_time_us(4 * latency_us), link_up, NULL);
+    return 0;
+}
+
+int cyw43_tcpip_link_status(cyw43_t *self, int itf)
+{
+    (void)itf;
+    return self->link_status;
+}
+
+void mock_net_set_link(bool up)
+{
+    link_allowed = up;
+    if (!up)
+        cyw43_state.link_status = CYW43_LINK_DOWN;
+}
+
+void mock_net_set_dns(bool resolves)
+{
+    dns_resolves = resolves;
+}
+
+void mock_net_set_latency_us(uint32_t us)
+{
+    latency_us = us;
+}
+
+uint32_t mock_net_latency_us(void)
+{
+    return latency_us;
+}
+
+bool mock_net_link_up(void)
+{
+    return cyw43_state.link_status == CYW43_LINK_UP;
+}
+
+// DNS
+
+typedef struct
+{
+    const char *name;
+    dns_found_callback found;
+    void *arg;
+} dns_query_t;
+
+static dns_query_t dns_query;
+
+static void dns_answer(void *arg)
+{
+    dns_query_t *query = (dns_query_t *)arg;
+    static ip_addr_t broker = {.addr = 0x0100000a}; // 10.0.0.1
+    query->found(query->name, dns_resolves && mock_net_link_up() ? &broker : NULL, query->arg);
+}
+
+err_t dns_gethostbyname(const char *hostname, ip_addr_t *addr, dns_found_callback found, void *callback_arg)
+{
+    (void)addr;
+    if (!mock_net_link_up())
+        return ERR_CONN;
+
+    dns_query = (dns_query_t){.name = hostname, .found = found, .arg = callback_arg};
+    mock_context_schedule(make_timeout_time_us(2 * latency_us), dns_answer, &dns_query);
+    return ERR_INPROGRESS;
+}
+
+char *ipaddr_ntoa(const ip_addr_t *addr)
+{
+    static char buf[16];
+    snprintf(buf, sizeof(buf), "%u.%u.%u.%u", addr->addr & 0xff, (addr->addr >> 8) & 0xff, (addr->addr >> 16) & 0xff,
+             addr->addr >> 24);
+    return buf;
+}
+
+// Identificação e números aleatórios
+
+void pico_get_unique_board_id_string(char *id_out, uint len)
+{
+    snprintf(id_out, len, "E6614C311B4F6A2C");
+}
+
+void mock_rand_seed(uint32_t seed)
+{
+    rand_state = seed ? seed : 1;
+}
+
+uint32_t get_rand_32(void)
+{
+    // xorshift32: a mesma semente gera o mesmo jitter de reconexão em toda execução
+    rand_state ^= rand_state << 13;
+    rand_state ^= rand_state >> 17;
+    rand_state ^= rand_state << 5;
+    return rand_state;
+}
+
+uint64_t get_rand_64(void)
+{
+    return ((uint64_t)get_rand_32() << 32) | get_rand_32();
+}
@@ -0,0 +1,200 @@
+#include "mock_hal.h"
+#include "hardware/dma.h"
+#include "hardware/irq.h"
+
+// DMA: o destino configurado decide o barramento. Palavras DATA_CMD para o I2C viram transações
+// (RESTART/STOP separam uma da outra) e palavras para a FIFO de uma máquina PIO são enfileiradas nela.
+// A conclusão chega como interrupção quando o barramento termina de enviar
+
+typedef struct
+{
+    bool claimed;
+    bool busy;
+    bool irq0_enabled;
+    bool irq0_status;
+    dma_channel_config config;
+    volatile void *write_addr;
+    const volatile void *read_addr;
+    uint transfer_count;
+    i2c_inst_t *i2c; // Destino I2C da transferência em andamento (para a interrupção de STOP)
+} dma_channel_t;
+
+static dma_channel_t channels[NUM_DMA_CHANNELS];
+static uint8_t i2c_transaction[4096];
+
+int dma_claim_unused_channel(bool required)
+{
+    for (int ch = 0; ch < NUM_DMA_CHANNELS; ch++)
+    {
+        if (!channels[ch].claimed)
+        {
+            channels[ch].claimed = true;
+            return ch;
+        }
+    }
+    if (required)
+        panic("no free dma channel\n");
+    return -1;
+}
+
+void dma_channel_unclaim(uint channel)
+{
+    channels[channel].claimed = false;
+}
+
+dma_channel_config dma_channel_get_default_config(uint channel)
+{
+    (void)channel;
+    return (dma_channel_config){.size = DMA_SIZE_32, .read_increment = true, .write_increment = false, .dreq = 0x3f};
+}
+
+void dma_channel_configure(uint channel, const dma_channel_config *config, volatile void *write_addr,
+                           const volatile void *read_addr, uint transfer_count, bool trigger)
+{
+    dma_channel_t *ch = &channels[channel];
+    ch->config = *config;
+    ch->write_addr = write_addr;
+    ch->read_addr = read_addr;
+    ch->transfer_count = transfer_count;
+    if (trigger)
+        dma_channel_transfer_from_buffer_now(channel, read_addr, transfer_count);
+}
+
+static void dma_complete(void *arg)
+{
+    dma_channel_t *ch = (dma_channel_t *)arg;
+    if (!ch->busy)
+        return; // Abortada
+
+    // NACK: o I2C aborta, descarta a FIFO e o canal fica parado até ser abortado pelo driver
+    if (ch->i2c && (ch->i2c->hw->intr_stat & I2C_IC_INTR_STAT_R_TX_ABRT_BITS))
+    {
+        if (ch->i2c->hw->intr_mask & I2C_IC_INTR_MASK_M_TX_ABRT_BITS)
+            mock_irq_fire(i2c_hw_index(ch->i2c) ? I2C1_IRQ : I2C0_IRQ);
+        return;
+    }
+
+    ch->busy = false;
+    if (ch->irq0_enabled)
+    {
+        ch->irq0_status = true;
+        mock_irq_fire(DMA_IRQ_0);
+    }
+
+    // O STOP saiu com a última palavra
+    if (ch->i2c && (ch->i2c->hw->intr_mask & I2C_IC_INTR_MASK_M_STOP_DET_BITS))
+        mock_irq_fire(i2c_hw_index(ch->i2c) ? I2C1_IRQ : I2C0_IRQ);
+}
+
+// Separa as palavras DATA_CMD em transações e devolve o fim da última no barramento.
+// Um NACK interrompe o resto da rajada e sinaliza TX_ABRT
+static absolute_time_t dma_to_i2c(i2c_inst_t *i2c, const uint16_t *words, uint32_t count)
+{
+    uint64_t busy_before = mock_bus_stats.i2c_busy_us;
+    size_t len = 0;
+    bool acked = true;
+
+    i2c->hw->intr_stat = 0; // O driver lê clr_tx_abrt antes de cada envio
+    for (uint32_t i = 0; i < count && acked; i++)
+    {
+        if ((words[i] & I2C_IC_DATA_CMD_RESTART_BITS) && len)
+        {
+            acked = mock_i2c_transfer(i2c, i2c->hw->tar, i2c_transaction, len);
+            len = 0;
+            if (!acked)
+                break;
+        }
+        if (len < sizeof(i2c_transaction))
+            i2c_transaction[len++] = words[i] & 0xff;
+        if (words[i] & I2C_IC_DATA_CMD_STOP_BITS)
+        {
+            acked = mock_i2c_transfer(i2c, i2c->hw->tar, i2c_transaction, len);
+            len = 0;
+        }
+    }
+    if (acked && len)
+        acked = mock_i2c_transfer(i2c, i2c->hw->tar, i2c_transaction, len);
+    if (!acked)
+        i2c->hw->intr_stat |= I2C_IC_INTR_STAT_R_TX_ABRT_BITS;
+
+    return get_absolute_time() + (mock_bus_stats.i2c_busy_us - busy_before);
+}
+
+void dma_channel_transfer_from_buffer_now(uint channel, const volatile void *read_addr, uint32_t transfer_count)
+{
+    dma_channel_t *ch = &channels[channel];
+    absolute_time_t done = get_absolute_time();
+
+    ch->read_addr = read_addr;
+    ch->transfer_count = transfer_count;
+    ch->i2c = NULL;
+    mock_bus_stats.dma_transfers++;
+    mock_bus_stats.dma_words += transfer_count;
+
+    bool routed = false;
+    for (int i = 0; i < 2; i++)
+    {
+        if (ch->write_addr == &mock_i2c_inst[i].hw->data_cmd)
+        {
+            ch->i2c = &mock_i2c_inst[i];
+            done = dma_to_i2c(ch->i2c, (const uint16_t *)read_addr, transfer_count);
+            routed = true;
+        }
+    }
+    for (int p = 0; p < 2; p++)
+    {
+        for (uint sm = 0; sm < NUM_PIO_STATE_MACHINES; sm++)
+        {
+            if (ch->write_addr == &mock_pio_hw[p].txf[sm])
+            {
+                done = mock_pio_push(&mock_pio_hw[p], sm, transfer_count);
+                routed = true;
+            }
+        }
+    }
+    if (!routed)
+        panic("dma channel %u: unsupported destination\n", channel);
+
+    ch->busy = true;
+    if (!mock_time_schedule(done, dma_complete, ch))
+        panic("mock event queue full\n");
+}
+
+bool dma_channel_is_busy(uint channel)
+{
+    return channels[channel].busy;
+}
+
+void dma_channel_wait_for_finish_blocking(uint channel)
+{
+    while (channels[channel].busy)
+        mock_time_idle();
+}
+
+// Como no RP2040 (errata E13), abortar um canal ativo pode sinalizar a interrupção de conclusão
+void dma_channel_abort(uint channel)
+{
+    dma_channel_t *ch = &channels[channel];
+    if (!ch->busy)
+        return;
+
+    ch->busy = false;
+    ch->irq0_status = true;
+    if (ch->irq0_enabled)
+        mock_irq_fire(DMA_IRQ_0);
+}
+
+void dma_channel_set_irq0_enabled(uint channel, bool enabled)
+{
+    channels[channel].irq0_enabled = enabled;
+}
+
+bool dma_channel_get_irq0_status(uint channel)
+{
+    return channels[channel].irq0_status;
+}
+
+void dma_channel_acknowledge_irq0(uint channel)
+{
+    channels[channel].irq0_status = false;
+}
@@ -0,0 +1,30 @@
+#include "mock_hal.h"
+#include "hardware/flash.h"
+
+// Flash em RAM: apagar deixa os bytes em 0xFF e programar só pode zerar bits, como na flash real
+
+uint8_t mock_flash[PICO_FLASH_SIZE_BYTES];
+
+__attribute__((constructor)) static void mock_flash_init(void)
+{
+    memset(mock_flash, 0xff, sizeof(mock_flash));
+}
+
+void flash_range_erase(uint32_t flash_offs, size_t count)
+{
+    if (flash_offs % FLASH_SECTOR_SIZE || count % FLASH_SECTOR_SIZE || flash_offs + count > PICO_FLASH_SIZE_BYTES)
+        panic("flash_range_erase(%lu, %lu) not sector aligned\n", (unsigned long)flash_offs, (unsigned long)count);
+
+    memset(&mock_flash[flash_offs], 0xff, count);
+    mock_bus_stats.flash_erased += count;
+}
+
+void flash_range_program(uint32_t flash_offs, const uint8_t *data, size_t count)
+{
+    if (flash_offs % FLASH_PAGE_SIZE || count % FLASH_PAGE_SIZE || flash_offs + count > PICO_FLASH_SIZE_BYTES)
+        panic("flash_range_program(%lu, %lu) not page aligned\n", (unsigned long)flash_offs, (unsigned long)count);
+
+    for (size_t i = 0; i < count; i++)
+        mock_flash[flash_offs + i] &= data[i];
+    mock_bus_stats.flash_programmed += count;
+}
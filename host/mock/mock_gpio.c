@@ -0,0 +1,136 @@
+#include "mock_hal.h"
+#include "hardware/pwm.h"
+
+// GPIO e PWM: guardam o nível de cada pino; entradas mudam por mock_gpio_set_input/mock_gpio_press
+
+static bool levels[NUM_BANK0_GPIOS];
+static bool pulled_up[NUM_BANK0_GPIOS];
+static uint32_t irq_mask[NUM_BANK0_GPIOS];
+static uint16_t pwm_levels[NUM_BANK0_GPIOS];
+static gpio_irq_callback_t irq_callback = NULL;
+
+void gpio_init(uint gpio)
+{
+    levels[gpio] = false;
+}
+
+void gpio_set_function(uint gpio, enum gpio_function fn)
+{
+    (void)gpio;
+    (void)fn;
+}
+
+void gpio_set_dir(uint gpio, bool out)
+{
+    (void)gpio;
+    (void)out;
+}
+
+void gpio_pull_up(uint gpio)
+{
+    pulled_up[gpio] = true;
+    levels[gpio] = true;
+}
+
+void gpio_pull_down(uint gpio)
+{
+    pulled_up[gpio] = false;
+    levels[gpio] = false;
+}
+
+void gpio_disable_pulls(uint gpio)
+{
+    pulled_up[gpio] = false;
+}
+
+bool gpio_get(uint gpio)
+{
+    return levels[gpio];
+}
+
+void gpio_put(uint gpio, bool value)
+{
+    mock_bus_stats.gpio_writes++;
+    levels[gpio] = value;
+}
+
+void gpio_set_irq_enabled(uint gpio, uint32_t event_mask, bool enabled)
+{
+    if (enabled)
+        irq_mask[gpio] |= event_mask;
+    else
+        irq_mask[gpio] &= ~event_mask;
+}
+
+void gpio_set_irq_enabled_with_callback(uint gpio, uint32_t event_mask, bool enabled, gpio_irq_callback_t callback)
+{
+    irq_callback = callback;
+    gpio_set_irq_enabled(gpio, event_mask, enabled);
+}
+
+// Muda o nível de uma entrada; a borda aciona o callback como a interrupção de GPIO
+void mock_gpio_set_input(uint gpio, bool level)
+{
+    if (levels[gpio] == level)
+        return;
+
+    levels[gpio] = level;
+    uint32_t event = level ? GPIO_IRQ_EDGE_RISE : GPIO_IRQ_EDGE_FALL;
+    if (irq_callback && (irq_mask[gpio] & event))
+    {
+        mock_bus_stats.irqs++;
+        irq_callback(gpio, event);
+    }
+}
+
+static void gpio_release(void *arg)
+{
+    mock_gpio_set_input((uint)(uintptr_t)arg, true);
+}
+
+void mock_gpio_press(uint gpio, uint32_t hold_ms)
+{
+    mock_gpio_set_input(gpio, false);
+    mock_time_schedule(make_timeout_time_ms(hold_ms), gpio_release, (void *)(uintptr_t)gpio);
+}
+
+bool mock_gpio_get_output(uint gpio)
+{
+    return levels[gpio];
+}
+
+void pwm_init(uint slice_num, pwm_config *c, bool start)
+{
+    (void)slice_num;
+    (void)c;
+    (void)start;
+}
+
+void pwm_set_clkdiv(uint slice_num, float divider)
+{
+    (void)slice_num;
+    (void)divider;
+}
+
+void pwm_set_wrap(uint slice_num, uint16_t wrap)
+{
+    (void)slice_num;
+    (void)wrap;
+}
+
+void pwm_set_enabled(uint slice_num, bool enabled)
+{
+    (void)slice_num;
+    (void)enabled;
+}
+
+void pwm_set_gpio_level(uint gpio, uint16_t level)
+{
+    mock_bus_stats.pwm_writes++;
+    pwm_levels[gpio] = level;
+}
+
+uint16_t mock_pwm_get_level(uint gpio)
+{
+    return pwm_levels[gpio];
+}
@@ -0,0 +1,231 @@
+#include "mock_hal.h"
+
+#define MOCK_MAX_EVENTS 64
+
+// Evento agendado; alarmes guardam o callback do SDK e o id devolvido ao firmware
+typedef struct
+{
+    bool used;
+    absolute_time_t at;
+    uint32_t order; // Desempate: eventos no mesmo instante saem na ordem em que foram agendados
+    mock_event_fn_t fn;
+    void *arg;
+    alarm_callback_t alarm;
+    alarm_id_t alarm_id;
+} mock_event_t;
+
+typedef struct
+{
+    mock_event_t events[MOCK_MAX_EVENTS];
+} mock_queue_t;
+
+mock_bus_stats_t mock_bus_stats;
+
+static uint64_t now_us = 0;
+static absolute_time_t time_limit = 0;
+static uint32_t next_order = 0;
+static alarm_id_t next_alarm_id = 1;
+static mock_queue_t irq_queue;     // Disparados durante qualquer avanço do relógio
+static mock_queue_t context_queue; // Disparados só pelo contexto assíncrono
+
+static mock_event_t *queue_add(mock_queue_t *queue, absolute_time_t at)
+{
+    for (int i = 0; i < MOCK_MAX_EVENTS; i++)
+    {
+        mock_event_t *event = &queue->events[i];
+        if (!event->used)
+        {
+            memset(event, 0, sizeof(*event));
+            event->used = true;
+            event->at = at;
+            event->order = next_order++;
+            return event;
+        }
+    }
+    return NULL;
+}
+
+static mock_event_t *queue_earliest(mock_queue_t *queue)
+{
+    mock_event_t *earliest = NULL;
+    for (int i = 0; i < MOCK_MAX_EVENTS; i++)
+    {
+        mock_event_t *event = &queue->events[i];
+        if (event->used && (!earliest || event->at < earliest->at ||
+                            (event->at == earliest->at && event->order < earliest->order)))
+            earliest = event;
+    }
+    return earliest;
+}
+
+// Retira o evento da fila antes de executá-lo: o callback pode agendar outros
+static void event_fire(mock_event_t *event)
+{
+    mock_event_t copy = *event;
+    event->used = false;
+
+    if (!copy.alarm)
+    {
+        copy.fn(copy.arg);
+        return;
+    }
+
+    mock_bus_stats.irqs++;
+    int64_t next = copy.alarm(copy.alarm_id, copy.arg);
+    if (next == 0)
+        return;
+
+    // > 0: a partir de agora; < 0: a partir do prazo anterior (mesma semântica do SDK)
+    mock_event_t *again = queue_add(&irq_queue, next > 0 ? now_us + next : copy.at - next);
+    if (again)
+    {
+        again->alarm = copy.alarm;
+        again->alarm_id = copy.alarm_id;
+        again->arg = copy.arg;
+    }
+}
+
+uint64_t mock_time_now_us(void)
+{
+    return now_us;
+}
+
+void mock_time_advance_us(uint64_t us)
+{
+    absolute_time_t target = now_us + us;
+    mock_event_t *event;
+
+    while ((event = queue_earliest(&irq_queue)) && event->at <= target)
+    {
+        if (event->at > now_us)
+            now_us = event->at;
+        event_fire(event);
+    }
+    now_us = target;
+
+    if (time_limit && now_us > time_limit)
+    {
+        fprintf(stderr, "virtual time limit reached at %llu us\n", (unsigned long long)now_us);
+        exit(2);
+    }
+}
+
+// Espera ativa do firmware: só um evento de interrupção pode mudar o que ele espera
+void mock_time_idle(void)
+{
+    mock_event_t *event = queue_earliest(&irq_queue);
+    if (!event)
+        panic("busy wait with no pending interrupt at %llu us\n", (unsigned long long)now_us);
+
+    mock_time_advance_us(event->at > now_us ? event->at - now_us : 0);
+}
+
+bool mock_time_schedule(absolute_time_t at, mock_event_fn_t fn, void *arg)
+{
+    mock_event_t *event = queue_add(&irq_queue, at);
+    if (!event)
+        return false;
+    event->fn = fn;
+    event->arg = arg;
+    return true;
+}
+
+bool mock_context_schedule(absolute_time_t at, mock_event_fn_t fn, void *arg)
+{
+    mock_event_t *event = queue_add(&context_queue, at);
+    if (!event)
+        return false;
+    event->fn = fn;
+    event->arg = arg;
+    return true;
+}
+
+bool mock_time_next_event(absolute_time_t *at)
+{
+    mock_event_t *event = queue_earliest(&irq_queue);
+    if (event)
+        *at = event->at;
+    return event != NULL;
+}
+
+bool mock_context_next_event(absolute_time_t *at)
+{
+    mock_event_t *event = queue_earliest(&context_queue);
+    if (event)
+        *at = event->at;
+    return event != NULL;
+}
+
+bool mock_context_run_due(void)
+{
+    bool ran = false;
+    mock_event_t *event;
+    while ((event = queue_earliest(&context_queue)) && event->at <= now_us)
+    {
+        event_fire(event);
+        ran = true;
+    }
+    return ran;
+}
+
+void mock_time_set_limit(absolute_time_t limit)
+{
+    time_limit = limit;
+}
+
+void mock_bus_stats_reset(void)
+{
+    memset(&mock_bus_stats, 0, sizeof(mock_bus_stats));
+}
+
+void mock_time_reset(void)
+{
+    now_us = 0;
+    memset(&irq_queue, 0, sizeof(irq_queue));
+    memset(&context_queue, 0, sizeof(context_queue));
+}
+
+alarm_id_t add_alarm_at(absolute_time_t time, alarm_callback_t callback, void *user_data, bool fire_if_past)
+{
+    if (time <= now_us)
+    {
+        if (fire_if_past)
+        {
+            mock_bus_stats.irqs++;
+            callback(0, user_data);
+        }
+        return 0;
+    }
+
+    mock_event_t *event = queue_add(&irq_queue, time);
+    if (!event)
+        return -1;
+    event->alarm = callback;
+    event->alarm_id = next_alarm_id++;
+    event->arg = user_data;
+    return event->alarm_id;
+}
+
+alarm_id_t add_alarm_in_us(uint64_t us, alarm_callback_t callback, void *user_data, bool fire_if_past)
+{
+    return add_alarm_at(now_us + us, callback, user_data, fire_if_past);
+}
+
+alarm_id_t add_alarm_in_ms(uint32_t ms, alarm_callback_t callback, void *user_data, bool fire_if_past)
+{
+    return add_alarm_at(now_us + ms * 1000ull, callback, user_data, fire_if_past);
+}
+
+bool cancel_alarm(alarm_id_t alarm_id)
+{
+    for (int i = 0; i < MOCK_MAX_EVENTS; i++)
+    {
+        mock_event_t *event = &irq_queue.events[i];
+        if (event->used && event->alarm && event->alarm_id == alarm_id)
+        {
+            event->used = false;
+            return true;
+        }
+    }
+    return false;
+}
@@ -0,0 +1,92 @@
+#ifndef MOCK_HAL_H
+#define MOCK_HAL_H
+
+// Controle do HAL simulado pela build de host: relógio virtual, eventos agendados, bytes enviados
+// em cada barramento e a rede/broker MQTT simulados
+
+#include <stdio.h>
+#include "pico/stdlib.h"
+#include "hardware/i2c.h"
+#include "hardware/pio.h"
+
+// Eventos agendados no relógio virtual
+typedef void (*mock_event_fn_t)(void *arg);
+
+bool mock_time_schedule(absolute_time_t at, mock_event_fn_t fn, void *arg);    // Nível de interrupção (alarmes, DMA, GPIO)
+bool mock_context_schedule(absolute_time_t at, mock_event_fn_t fn, void *arg); // Contexto assíncrono (rede, MQTT)
+bool mock_time_next_event(absolute_time_t *at);                                // Próximo evento de interrupção
+bool mock_context_next_event(absolute_time_t *at);                             // Próximo evento do contexto
+bool mock_context_run_due(void);                                               // Executa os eventos vencidos do contexto
+void mock_time_set_limit(absolute_time_t limit); // Encerra a execução (exit 2) se o relógio passar do limite
+void mock_time_reset(void);                      // Relógio em 0 e filas vazias
+
+// Tráfego dos barramentos e tempo que cada um ficou ocupado
+typedef struct
+{
+    uint64_t i2c_transactions;
+    uint64_t i2c_bytes;   // Inclui o byte de endereço de cada transação
+    uint64_t i2c_busy_us; // 9 bits por byte na taxa configurada
+    uint64_t i2c_nacks;   // Transações sem dispositivo que respondesse
+    uint64_t pio_words;
+    uint64_t pio_busy_us;
+    uint64_t dma_transfers;
+    uint64_t dma_words;
+    uint64_t gpio_writes;
+    uint64_t pwm_writes;
+    uint64_t irqs;
+    uint64_t flash_erased; // Bytes
+    uint64_t flash_programmed;
+} mock_bus_stats_t;
+
+extern mock_bus_stats_t mock_bus_stats;
+void mock_bus_stats_reset(void);
+
+// GPIO: entradas controladas pelo simulador (borda de descida aciona a interrupção)
+void mock_gpio_set_input(uint gpio, bool level);
+void mock_gpio_press(uint gpio, uint32_t hold_ms); // Pressiona agora e solta depois de hold_ms
+bool mock_gpio_get_output(uint gpio);
+uint16_t mock_pwm_get_level(uint gpio);
+
+// Dispositivos I2C: recebem os bytes de cada transação endereçada a eles
+typedef void (*mock_i2c_device_fn_t)(void *device, const uint8_t *data, size_t len);
+void mock_i2c_attach(i2c_inst_t *i2c, uint8_t addr, mock_i2c_device_fn_t fn, void *device);
+bool mock_i2c_transfer(i2c_inst_t *i2c, uint8_t addr, const uint8_t *data, size_t len); // Registra sem esperar (DMA); false = NACK
+void mock_i2c_set_nack(i2c_inst_t *i2c, uint8_t addr, bool nack);                       // Simula o dispositivo desconectado
+
+// PIO: enfileira palavras sem esperar e devolve o fim da saída da última (usado pelo DMA)
+absolute_time_t mock_pio_push(PIO pio, uint sm, uint32_t count);
+
+// Interrupções
+void mock_irq_fire(uint num);
+
+// Wi-Fi e DNS
+void mock_net_set_link(bool up);         // Derruba ou restabelece o Wi-Fi
+void mock_net_set_dns(bool resolves);    // Falha as próximas consultas de DNS
+void mock_net_set_latency_us(uint32_t us); // Meio RTT: DNS, envio e confirmação levam múltiplos disso
+uint32_t mock_net_latency_us(void);
+bool mock_net_link_up(void);
+
+// Broker MQTT simulado
+typedef struct
+{
+    uint32_t connects;
+    uint32_t publishes;        // Mensagens aceitas por mqtt_publish
+    uint32_t publish_rejected; // Recusadas (desconectado, sem requisição livre ou buffer cheio)
+    uint64_t publish_bytes;    // Bytes no fio (cabeçalho MQTT + tópico + payload)
+    uint64_t payload_bytes;
+    uint32_t subscribes;
+    uint32_t deliveries;       // Mensagens entregues ao firmware
+    uint64_t delivered_bytes;
+} mock_mqtt_stats_t;
+
+extern mock_mqtt_stats_t mock_mqtt_stats;
+
+typedef void (*mock_mqtt_publish_hook_t)(const char *topic, const uint8_t *payload, size_t len, uint8_t qos, bool retain, void *arg);
+void mock_mqtt_set_publish_hook(mock_mqtt_publish_hook_t hook, void *arg);
+void mock_mqtt_set_broker(bool online);  // Broker fora do ar: conexões falham
+void mock_mqtt_drop_connection(void);    // Queda da conexão atual (o firmware recebe MQTT_CONNECT_DISCONNECTED)
+bool mock_mqtt_deliver(const char *topic, const void *payload, size_t len); // Entrega se houver assinatura
+
+void mock_rand_seed(uint32_t seed);
+
+#endif // MOCK_HAL_H
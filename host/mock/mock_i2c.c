@@ -0,0 +1,84 @@
+#include "mock_hal.h"
+
+#define MOCK_I2C_MAX_DEVICES 4
+
+// Barramentos I2C: contam transações, bytes e o tempo de barramento (9 bits por byte, com o ACK)
+
+typedef struct
+{
+    i2c_inst_t *i2c;
+    uint8_t addr;
+    mock_i2c_device_fn_t fn;
+    void *device;
+    bool nack; // Desconectado: não responde ao endereço
+} i2c_device_t;
+
+static i2c_hw_t i2c_hw[2];
+i2c_inst_t mock_i2c_inst[2] = {{.hw = &i2c_hw[0], .baudrate = 100000}, {.hw = &i2c_hw[1], .baudrate = 100000}};
+static i2c_device_t devices[MOCK_I2C_MAX_DEVICES];
+
+uint i2c_init(i2c_inst_t *i2c, uint baudrate)
+{
+    i2c->baudrate = baudrate;
+    i2c->hw->enable = 1;
+    return baudrate;
+}
+
+void mock_i2c_attach(i2c_inst_t *i2c, uint8_t addr, mock_i2c_device_fn_t fn, void *device)
+{
+    for (int i = 0; i < MOCK_I2C_MAX_DEVICES; i++)
+    {
+        if (!devices[i].fn || (devices[i].i2c == i2c && devices[i].addr == addr))
+        {
+            devices[i] = (i2c_device_t){.i2c = i2c, .addr = addr, .fn = fn, .device = device};
+            return;
+        }
+    }
+    panic("too many i2c devices\n");
+}
+
+void mock_i2c_set_nack(i2c_inst_t *i2c, uint8_t addr, bool nack)
+{
+    for (int i = 0; i < MOCK_I2C_MAX_DEVICES; i++)
+    {
+        if (devices[i].fn && devices[i].i2c == i2c && devices[i].addr == addr)
+            devices[i].nack = nack;
+    }
+}
+
+static uint64_t i2c_duration_us(const i2c_inst_t *i2c, size_t bytes)
+{
+    return (bytes * 9 * 1000000ull + i2c->baudrate - 1) / i2c->baudrate;
+}
+
+// Registra uma transação (endereço + dados) e a entrega ao dispositivo, sem avançar o relógio.
+// Sem dispositivo que responda, só o byte de endereço vai ao barramento e retorna false (NACK)
+bool mock_i2c_transfer(i2c_inst_t *i2c, uint8_t addr, const uint8_t *data, size_t len)
+{
+    for (int i = 0; i < MOCK_I2C_MAX_DEVICES; i++)
+    {
+        if (devices[i].fn && devices[i].i2c == i2c && devices[i].addr == addr && !devices[i].nack)
+        {
+            mock_bus_stats.i2c_transactions++;
+            mock_bus_stats.i2c_bytes += len + 1;
+            mock_bus_stats.i2c_busy_us += i2c_duration_us(i2c, len + 1);
+            devices[i].fn(devices[i].device, data, len);
+            return true;
+        }
+    }
+
+    mock_bus_stats.i2c_transactions++;
+    mock_bus_stats.i2c_nacks++;
+    mock_bus_stats.i2c_bytes++;
+    mock_bus_stats.i2c_busy_us += i2c_duration_us(i2c, 1);
+    return false;
+}
+
+int i2c_write_blocking(i2c_inst_t *i2c, uint8_t addr, const uint8_t *src, size_t len, bool nostop)
+{
+    (void)nostop;
+    uint64_t busy_before = mock_bus_stats.i2c_busy_us;
+    bool acked = mock_i2c_transfer(i2c, addr, src, len);
+    mock_time_advance_us(mock_bus_stats.i2c_busy_us - busy_before);
+    return acked ? (int)len : PICO_ERROR_GENERIC;
+}
@@ -0,0 +1,56 @@
+#include "mock_hal.h"
+#include "hardware/irq.h"
+
+#define MOCK_IRQ_MAX_HANDLERS 4
+
+// Tabela de tratadores: exclusivos ocupam a primeira posição, compartilhados são chamados em ordem
+
+static irq_handler_t handlers[NUM_IRQS][MOCK_IRQ_MAX_HANDLERS];
+static bool enabled[NUM_IRQS];
+
+void irq_set_enabled(uint num, bool enable)
+{
+    enabled[num] = enable;
+}
+
+void irq_set_exclusive_handler(uint num, irq_handler_t handler)
+{
+    memset(handlers[num], 0, sizeof(handlers[num]));
+    handlers[num][0] = handler;
+}
+
+void irq_add_shared_handler(uint num, irq_handler_t handler, uint8_t order_priority)
+{
+    (void)order_priority;
+    for (int i = 0; i < MOCK_IRQ_MAX_HANDLERS; i++)
+    {
+        if (!handlers[num][i])
+        {
+            handlers[num][i] = handler;
+            return;
+        }
+    }
+    panic("too many shared handlers on irq %u\n", num);
+}
+
+void irq_remove_handler(uint num, irq_handler_t handler)
+{
+    for (int i = 0; i < MOCK_IRQ_MAX_HANDLERS; i++)
+    {
+        if (handlers[num][i] == handler)
+            handlers[num][i] = NULL;
+    }
+}
+
+void mock_irq_fire(uint num)
+{
+    if (!enabled[num])
+        return;
+
+    mock_bus_stats.irqs++;
+    for (int i = 0; i < MOCK_IRQ_MAX_HANDLERS; i++)
+    {
+        if (handlers[num][i])
+            handlers[num][i]();
+    }
+}
@@ -0,0 +1,334 @@
+#include "mock_hal.h"
+#include "lwip/apps/mqtt.h"
+#include "lwip/apps/mqtt_priv.h"
+
+// Cliente MQTT do lwIP com um broker simulado. Mantém os limites que importam ao firmware
+// (MQTT_REQ_MAX_IN_FLIGHT requisições, MQTT_OUTPUT_RINGBUF_SIZE bytes no buffer de saída,
+// fragmentos de MQTT_VAR_HEADER_BUFFER_LEN bytes na entrada) e conta os bytes no fio.
+// O buffer de saída é liberado logo após o envio; o callback da requisição vem um RTT depois
+// (confirmação do TCP no QoS 0, PUBACK/SUBACK no QoS 1)
+
+mock_mqtt_stats_t mock_mqtt_stats;
+
+static mqtt_client_t *active_client = NULL;
+static bool broker_online = true;
+static mock_mqtt_publish_hook_t publish_hook = NULL;
+static void *publish_hook_arg = NULL;
+
+// Evento de rede ligado a uma conexão: descartado se a conexão mudou até ele vencer
+typedef struct
+{
+    mqtt_client_t *client;
+    uint32_t session;
+    struct mqtt_request_t *request;
+    u16_t bytes;
+    char *topic;
+    uint8_t *payload;
+    size_t len;
+} mqtt_event_t;
+
+static mqtt_event_t *event_new(mqtt_client_t *client)
+{
+    mqtt_event_t *event = calloc(1, sizeof(*event));
+    event->client = client;
+    event->session = client->session;
+    return event;
+}
+
+static bool event_stale(const mqtt_event_t *event)
+{
+    return event->client->session != event->session;
+}
+
+static void event_free(mqtt_event_t *event)
+{
+    free(event->topic);
+    free(event->payload);
+    free(event);
+}
+
+// Tamanho do pacote: cabeçalho fixo (1 byte + comprimento variável) + resto
+static size_t packet_bytes(size_t remaining)
+{
+    size_t header = 2;
+    for (size_t n = remaining; n >= 128; n /= 128)
+        header++;
+    return header + remaining;
+}
+
+// Filtro de assinatura com "+" (um nível) e "#" (o resto)
+static bool topic_matches(const char *filter, const char *topic)
+{
+    while (*filter)
+    {
+        if (*filter == '#')
+            return true;
+        if (*filter == '+')
+        {
+            while (*topic && *topic != '/')
+                topic++;
+            filter++;
+            continue;
+        }
+        if (*filter++ != *topic++)
+            return false;
+    }
+    return *topic == '\0';
+}
+
+static void client_reset_connection(mqtt_client_t *client)
+{
+    client->conn_state = 0;
+    client->session++;
+    client->ringbuf_used = 0;
+    memset(client->req_list, 0, sizeof(client->req_list)); // Como no lwIP: pendentes somem sem callback
+    memset(client->subscriptions, 0, sizeof(client->subscriptions));
+}
+
+mqtt_client_t *mqtt_client_new(void)
+{
+    mqtt_client_t *client = calloc(1, sizeof(mqtt_client_t));
+    active_client = client;
+    return client;
+}
+
+void mqtt_client_free(mqtt_client_t *client)
+{
+    if (active_client == client)
+        active_client = NULL;
+    free(client);
+}
+
+static void connect_result(void *arg)
+{
+    mqtt_event_t *event = (mqtt_event_t *)arg;
+    mqtt_client_t *client = event->client;
+    bool stale = event_stale(event) || client->conn_state != 1;
+    event_free(event);
+    if (stale)
+        return;
+
+    if (broker_online && mock_net_link_up())
+    {
+        client->conn_state = 2;
+        mock_mqtt_stats.connects++;
+        client->connect_cb(client, client->connect_arg, MQTT_CONNECT_ACCEPTED);
+    }
+    else
+    {
+        client_reset_connection(client);
+        client->connect_cb(client, client->connect_arg, MQTT_CONNECT_DISCONNECTED);
+    }
+}
+
+err_t mqtt_client_connect(mqtt_client_t *client, const ip_addr_t *ipaddr, u16_t port, mqtt_connection_cb_t cb, void *arg,
+                          const struct mqtt_connect_client_info_t *client_info)
+{
+    (void)ipaddr;
+    (void)port;
+    (void)client_info;
+    if (client->conn_state != 0)
+        return ERR_ISCONN;
+
+    uint32_t session = client->session;
+    memset(client, 0, sizeof(*client)); // Inclusive os callbacks de entrada
+    client->session = session + 1;
+    client->conn_state = 1;
+    client->connect_cb = cb;
+    client->connect_arg = arg;
+    active_client = client;
+
+    // TCP + CONNECT/CONNACK: dois RTTs
+    mock_context_schedule(make_timeout_time_us(4 * mock_net_latency_us()), connect_result, event_new(client));
+    return ERR_OK;
+}
+
+void mqtt_disconnect(mqtt_client_t *client)
+{
+    client_reset_connection(client); // Sem callback de conexão, como no lwIP
+}
+
+u8_t mqtt_client_is_connected(mqtt_client_t *client)
+{
+    return client->conn_state == 2;
+}
+
+void mqtt_set_inpub_callback(mqtt_client_t *client, mqtt_incoming_publish_cb_t pub_cb, mqtt_incoming_data_cb_t data_cb,
+                             void *arg)
+{
+    client->pub_cb = pub_cb;
+    client->data_cb = data_cb;
+    client->inpub_arg = arg;
+}
+
+static void request_sent(void *arg)
+{
+    mqtt_event_t *event = (mqtt_event_t *)arg;
+    if (!event_stale(event))
+        event->client->ringbuf_used -= event->bytes;
+    event_free(event);
+}
+
+static void request_done(void *arg)
+{
+    mqtt_event_t *event = (mqtt_event_t *)arg;
+    struct mqtt_request_t request = *event->request;
+    bool stale = event_stale(event);
+    event->request->used = false;
+    event_free(event);
+
+    if (!stale && request.cb)
+        request.cb(request.arg, ERR_OK);
+}
+
+// Reserva uma requisição e espaço no buffer de saída; o envio e a confirmação ficam agendados
+static err_t request_start(mqtt_client_t *client, size_t bytes, mqtt_request_cb_t cb, void *arg)
+{
+    if (client->conn_state != 2)
+        return ERR_CONN;
+    if (client->ringbuf_used + bytes > MQTT_OUTPUT_RINGBUF_SIZE)
+        return ERR_MEM;
+
+    for (int i = 0; i < MQTT_REQ_MAX_IN_FLIGHT; i++)
+    {
+        struct mqtt_request_t *request = &client->req_list[i];
+        if (request->used)
+            continue;
+
+        *request = (struct mqtt_request_t){.used = true, .cb = cb, .arg = arg, .ringbuf_bytes = bytes};
+        client->ringbuf_used += bytes;
+
+        mqtt_event_t *sent = event_new(client);
+        sent->bytes = bytes;
+        mock_context_schedule(get_absolute_time(), request_sent, sent);
+
+        mqtt_event_t *done = event_new(client);
+        done->request = request;
+        mock_context_schedule(make_timeout_time_us(2 * mock_net_latency_us()), request_done, done);
+        return ERR_OK;
+    }
+    return ERR_MEM;
+}
+
+err_t mqtt_publish(mqtt_client_t *client, const char *topic, const void *payload, u16_t payload_length, u8_t qos,
+                   u8_t retain, mqtt_request_cb_t cb, void *arg)
+{
+    size_t bytes = packet_bytes(2 + strlen(topic) + (qos ? 2 : 0) + payload_length);
+    err_t err = request_start(client, bytes, cb, arg);
+    if (err != ERR_OK)
+    {
+        mock_mqtt_stats.publish_rejected++;
+        return err;
+    }
+
+    mock_mqtt_stats.publishes++;
+    mock_mqtt_stats.publish_bytes += bytes;
+    mock_mqtt_stats.payload_bytes += payload_length;
+    if (publish_hook)
+        publish_hook(topic, (const uint8_t *)payload, payload_length, qos, retain, publish_hook_arg);
+    return ERR_OK;
+}
+
+err_t mqtt_sub_unsub(mqtt_client_t *client, const char *topic, u8_t qos, mqtt_request_cb_t cb, void *arg, u8_t sub)
+{
+    size_t topic_len = strlen(topic);
+    if (topic_len >= MQTT_HOST_TOPIC_LEN)
+        return ERR_ARG;
+
+    err_t err = request_start(client, packet_bytes(2 + 2 + topic_len + (sub ? 1 : 0)), cb, arg);
+    if (err != ERR_OK)
+        return err;
+
+    for (int i = 0; i < MQTT_HOST_MAX_SUBSCRIPTIONS; i++)
+    {
+        char *entry = client->subscriptions[i];
+        if (!sub && strcmp(entry, topic) == 0)
+            entry[0] = '\0';
+        else if (sub && entry[0] == '\0')
+        {
+            memcpy(entry, topic, topic_len + 1);
+            mock_mqtt_stats.subscribes++;
+            break;
+        }
+    }
+    (void)qos;
+    return ERR_OK;
+}
+
+// Entrega uma mensagem ao firmware em fragmentos, como o lwIP: o primeiro divide o buffer com o tópico
+static void deliver(void *arg)
+{
+    mqtt_event_t *event = (mqtt_event_t *)arg;
+    mqtt_client_t *client = event->client;
+    if (event_stale(event) || !client->pub_cb || !client->data_cb)
+    {
+        event_free(event);
+        return;
+    }
+
+    mock_mqtt_stats.deliveries++;
+    mock_mqtt_stats.delivered_bytes += event->len;
+    client->pub_cb(client->inpub_arg, event->topic, event->len);
+
+    size_t offset = 0;
+    size_t room = MQTT_VAR_HEADER_BUFFER_LEN - MIN(strlen(event->topic) + 4, MQTT_VAR_HEADER_BUFFER_LEN - 1);
+    do
+    {
+        size_t chunk = MIN(event->len - offset, room);
+        bool last = offset + chunk == event->len;
+        client->data_cb(client->inpub_arg, event->payload ? event->payload + offset : NULL, chunk,
+                        last ? MQTT_DATA_FLAG_LAST : 0);
+        offset += chunk;
+        room = MQTT_VAR_HEADER_BUFFER_LEN;
+    } while (offset < event->len);
+
+    event_free(event);
+}
+
+bool mock_mqtt_deliver(const char *topic, const void *payload, size_t len)
+{
+    mqtt_client_t *client = active_client;
+    if (!client || client->conn_state != 2)
+        return false;
+
+    bool subscribed = false;
+    for (int i = 0; i < MQTT_HOST_MAX_SUBSCRIPTIONS && !subscribed; i++)
+        subscribed = client->subscriptions[i][0] && topic_matches(client->subscriptions[i], topic);
+    if (!subscribed)
+        return false;
+
+    mqtt_event_t *event = event_new(client);
+    event->topic = strdup(topic);
+    event->len = len;
+    if (len)
+    {
+        event->payload = malloc(len);
+        memcpy(event->payload, payload, len);
+    }
+    mock_context_schedule(make_timeout_time_us(mock_net_latency_us()), deliver, event);
+    return true;
+}
+
+void mock_mqtt_set_publish_hook(mock_mqtt_publish_hook_t hook, void *arg)
+{
+    publish_hook = hook;
+    publish_hook_arg = arg;
+}
+
+void mock_mqtt_drop_connection(void)
+{
+    mqtt_client_t *client = active_client;
+    if (!client || client->conn_state == 0)
+        return;
+
+    client_reset_connection(client);
+    if (client->connect_cb)
+        client->connect_cb(client, client->connect_arg, MQTT_CONNECT_DISCONNECTED);
+}
+
+void mock_mqtt_set_broker(bool online)
+{
+    broker_online = online;
+    if (!online)
+        mock_mqtt_drop_connection();
+}
@@ -0,0 +1,100 @@
+#include "mock_hal.h"
+
+#define MOCK_PIO_FIFO_DEPTH 8 // FIFO TX unida à RX
+
+// Máquinas PIO: cada palavra leva word_us para sair; put_blocking só espera quando a FIFO está cheia
+
+typedef struct
+{
+    bool claimed;
+    float word_us;
+    absolute_time_t busy_until; // Fim da saída da última palavra enfileirada
+} pio_sm_t;
+
+pio_hw_t mock_pio_hw[2];
+static pio_sm_t state_machines[2][NUM_PIO_STATE_MACHINES];
+
+uint pio_add_program(PIO pio, const pio_program_t *program)
+{
+    (void)pio;
+    (void)program;
+    return 0;
+}
+
+int pio_claim_unused_sm(PIO pio, bool required)
+{
+    for (uint sm = 0; sm < NUM_PIO_STATE_MACHINES; sm++)
+    {
+        if (!state_machines[pio_get_index(pio)][sm].claimed)
+        {
+            state_machines[pio_get_index(pio)][sm].claimed = true;
+            return (int)sm;
+        }
+    }
+    if (required)
+        panic("no free pio state machine\n");
+    return -1;
+}
+
+void pio_gpio_init(PIO pio, uint pin)
+{
+    (void)pio;
+    (void)pin;
+}
+
+int pio_sm_set_consecutive_pindirs(PIO pio, uint sm, uint pin_base, uint pin_count, bool is_out)
+{
+    (void)pio;
+    (void)sm;
+    (void)pin_base;
+    (void)pin_count;
+    (void)is_out;
+    return 0;
+}
+
+int pio_sm_init(PIO pio, uint sm, uint initial_pc, const pio_sm_config *config)
+{
+    (void)pio;
+    (void)sm;
+    (void)initial_pc;
+    (void)config;
+    return 0;
+}
+
+void pio_sm_set_enabled(PIO pio, uint sm, bool enabled)
+{
+    (void)pio;
+    (void)sm;
+    (void)enabled;
+}
+
+void mock_pio_set_word_us(PIO pio, uint sm, float word_us)
+{
+    state_machines[pio_get_index(pio)][sm].word_us = word_us;
+}
+
+// Enfileira "count" palavras e devolve quando a última termina de sair (usado pelo DMA)
+absolute_time_t mock_pio_push(PIO pio, uint sm, uint32_t count)
+{
+    pio_sm_t *state = &state_machines[pio_get_index(pio)][sm];
+    absolute_time_t start = MAX(state->busy_until, get_absolute_time());
+    uint64_t duration = (uint64_t)(count * state->word_us + 0.5f);
+
+    state->busy_until = start + duration;
+    mock_bus_stats.pio_words += count;
+    mock_bus_stats.pio_busy_us += duration;
+    return state->busy_until;
+}
+
+void pio_sm_put_blocking(PIO pio, uint sm, uint32_t data)
+{
+    pio_sm_t *state = &state_machines[pio_get_index(pio)][sm];
+    pio->txf[sm] = data;
+
+    // FIFO cheia: espera sair uma palavra
+    uint64_t backlog = (uint64_t)(MOCK_PIO_FIFO_DEPTH * state->word_us);
+    if (state->busy_until > get_absolute_time() + backlog)
+        mock_time_advance_us(state->busy_until - get_absolute_time() - backlog);
+
+    mock_pio_push(pio, sm, 1);
+}
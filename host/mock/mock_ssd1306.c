@@ -0,0 +1,149 @@
+#include "mock_ssd1306.h"
+
+// Quantidade de argumentos de cada comando com parâmetros
+static uint8_t command_args(uint8_t cmd)
+{
+    switch (cmd)
+    {
+    case 0x21: // Janela de colunas
+    case 0x22: // Janela de páginas
+        return 2;
+    case 0x20: // Modo de endereçamento
+    case 0x81: // Contraste
+    case 0xA8: // Multiplex
+    case 0xD3: // Deslocamento
+    case 0xD5: // Clock
+    case 0xD9: // Pré-carga
+    case 0xDA: // Pinos COM
+    case 0xDB: // VCOMH
+    case 0x8D: // Bomba de carga
+        return 1;
+    default:
+        return 0;
+    }
+}
+
+static void run_command(mock_ssd1306_t *oled, uint8_t cmd, const uint8_t *args)
+{
+    oled->commands++;
+    switch (cmd)
+    {
+    case 0x20:
+        oled->mode = args[0] & 0x03;
+        break;
+    case 0x21:
+        oled->col_start = oled->col = args[0] & 0x7F;
+        oled->col_end = args[1] & 0x7F;
+        break;
+    case 0x22:
+        oled->page_start = oled->page = args[0] & 0x07;
+        oled->page_end = args[1] & 0x07;
+        break;
+    case 0xAE:
+    case 0xAF:
+        oled->display_on = cmd & 1;
+        break;
+    default:
+        break;
+    }
+}
+
+static void feed_command(mock_ssd1306_t *oled, uint8_t byte)
+{
+    if (oled->pending_args)
+    {
+        oled->args[oled->arg_count++] = byte;
+        if (oled->arg_count == oled->pending_args)
+        {
+            oled->pending_args = 0;
+            run_command(oled, oled->pending_cmd, oled->args);
+        }
+        return;
+    }
+
+    uint8_t count = command_args(byte);
+    if (count)
+    {
+        oled->pending_cmd = byte;
+        oled->pending_args = count;
+        oled->arg_count = 0;
+    }
+    else
+        run_command(oled, byte, NULL);
+}
+
+// Grava um byte na GDDRAM e avança o ponteiro conforme o modo de endereçamento
+static void feed_data(mock_ssd1306_t *oled, uint8_t byte)
+{
+    oled->data_bytes++;
+    oled->gddram[oled->page][oled->col] = byte;
+
+    if (oled->mode == 1) // Vertical: páginas primeiro
+    {
+        if (oled->page++ >= oled->page_end)
+        {
+            oled->page = oled->page_start;
+            oled->col = oled->col >= oled->col_end ? oled->col_start : oled->col + 1;
+        }
+    }
+    else if (oled->col++ >= oled->col_end)
+    {
+        oled->col = oled->col_start;
+        if (oled->mode == 0)
+            oled->page = oled->page >= oled->page_end ? oled->page_start : oled->page + 1;
+    }
+}
+
+// Cada transação começa com bytes de controle: Co=1 (0x80/0xC0) vale para um byte,
+// Co=0 (0x00/0x40) vale para o resto da transação
+static void ssd1306_receive(void *device, const uint8_t *data, size_t len)
+{
+    mock_ssd1306_t *oled = (mock_ssd1306_t *)device;
+    size_t i = 0;
+
+    while (i < len)
+    {
+        uint8_t control = data[i++];
+        bool is_data = control & 0x40;
+        bool single = control & 0x80;
+
+        if (single)
+        {
+            if (i < len)
+                is_data ? feed_data(oled, data[i]) : feed_command(oled, data[i]);
+            i++;
+            continue;
+        }
+
+        for (; i < len; i++)
+            is_data ? feed_data(oled, data[i]) : feed_command(oled, data[i]);
+    }
+}
+
+void mock_ssd1306_attach(mock_ssd1306_t *oled, i2c_inst_t *i2c, uint8_t addr)
+{
+    memset(oled, 0, sizeof(*oled));
+    oled->col_end = MOCK_SSD1306_COLS - 1;
+    oled->page_end = MOCK_SSD1306_PAGES - 1;
+    mock_i2c_attach(i2c, addr, ssd1306_receive, oled);
+}
+
+bool mock_ssd1306_pixel(const mock_ssd1306_t *oled, uint8_t x, uint8_t y)
+{
+    return (oled->gddram[y / 8][x] >> (y % 8)) & 1;
+}
+
+void mock_ssd1306_print(const mock_ssd1306_t *oled, FILE *out)
+{
+    static const char *const glyphs[4] = {" ", "▀", "▄", "█"}; // Meio bloco superior/inferior
+
+    fprintf(out, "+%.*s+\n", MOCK_SSD1306_COLS, "--------------------------------------------------------------------------------------------------------------------------------");
+    for (int y = 0; y < MOCK_SSD1306_PAGES * 8; y += 2)
+    {
+        fputc('|', out);
+        for (int x = 0; x < MOCK_SSD1306_COLS; x++)
+            fputs(glyphs[mock_ssd1306_pixel(oled, x, y) | mock_ssd1306_pixel(oled, x, y + 1) << 1], out);
+        fputs("|\n", out);
+    }
+    fprintf(out, "+%.*s+\n", MOCK_SSD1306_COLS, "--------------------------------------------------------------------------------------------------------------------------------");
+}
@@ -0,0 +1,31 @@
+#ifndef MOCK_SSD1306_H
+#define MOCK_SSD1306_H
+
+// Modelo do controlador SSD1306: interpreta os bytes I2C e mantém a GDDRAM, para conferir
+// o que o firmware desenhou e quantos bytes cada atualização custou
+
+#include "mock_hal.h"
+
+#define MOCK_SSD1306_PAGES 8
+#define MOCK_SSD1306_COLS 128
+
+typedef struct
+{
+    uint8_t gddram[MOCK_SSD1306_PAGES][MOCK_SSD1306_COLS];
+    uint8_t mode; // 0 = horizontal, 1 = vertical, 2 = página
+    uint8_t col_start, col_end, col;
+    uint8_t page_start, page_end, page;
+    bool display_on;
+    uint8_t pending_cmd; // Comando aguardando argumentos
+    uint8_t pending_args;
+    uint8_t args[2];
+    uint8_t arg_count;
+    uint32_t commands;
+    uint32_t data_bytes;
+} mock_ssd1306_t;
+
+void mock_ssd1306_attach(mock_ssd1306_t *oled, i2c_inst_t *i2c, uint8_t addr);
+bool mock_ssd1306_pixel(const mock_ssd1306_t *oled, uint8_t x, uint8_t y);
+void mock_ssd1306_print(const mock_ssd1306_t *oled, FILE *out); // Tela em ASCII (2 linhas por caractere)
+
+#endif // MOCK_SSD1306_H
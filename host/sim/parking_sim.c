@@ -0,0 +1,196 @@
+#include <stdlib.h>
+#include "mock_hal.h"
+#include "mock_ssd1306.h"
+#include "lib/button/button.h"
+#include "lib/ssd1306/display.h"
+#include "lib/parking/parking_batch.h"
+
+// Simulação do firmware no host: roda o main() real contra o HAL simulado seguindo um roteiro
+// de botões, mensagens MQTT e quedas de conexão, e no fim mostra o tráfego de cada barramento
+
+int parking_firmware_main(void); // main() de src/main.c, renomeado na compilação
+
+#define SIM_LIMIT_S 120 // Encerra com erro se o roteiro não terminar até aqui
+
+static mock_ssd1306_t oled;
+static bool show_screen = false;
+static bool show_publishes = true;
+static FILE *trace_out = NULL; // Partes do dump de /trace, uma por linha em hexadecimal (entrada de tools/trace_decode.py)
+
+typedef enum
+{
+    STEP_PRESS,
+    STEP_DELIVER,
+    STEP_DROP,
+    STEP_BROKER,
+    STEP_DISPLAY,
+} sim_step_kind_t;
+
+typedef struct
+{
+    uint32_t at_ms;
+    sim_step_kind_t kind;
+    uint32_t value;     // GPIO do botão, broker no ar ou display conectado
+    const char *topic;
+    const uint8_t *payload;
+    size_t len;
+} sim_step_t;
+
+// Reserva das vagas 3 e 4 por 30 s em um único comando (formato LIST, sequência 7)
+static const uint8_t batch_reserve[] = {
+    PARKING_BATCH_LIST, 0x00, 0x07,
+    0x00, 0x03, 0x00, 0x1E,
+    0x00, 0x04, 0x00, 0x1E,
+};
+
+// Lote com mais itens que PARKING_BATCH_MAX_ITEMS (4 vagas): recusado inteiro, resposta com status 2
+static const uint8_t batch_too_many[] = {
+    PARKING_BATCH_LIST, 0x00, 0x08,
+    0x00, 0x01, 0x00, 0x1E,
+    0x00, 0x02, 0x00, 0x1E,
+    0x00, 0x03, 0x00, 0x1E,
+    0x00, 0x04, 0x00, 0x1E,
+    0x00, 0x05, 0x00, 0x1E,
+};
+
+static const sim_step_t script[] = {
+    {3000, STEP_PRESS, BTN_SW_PIN},                                     // Vaga 1 ocupada
+    {4000, STEP_DELIVER, 0, "/parking/2/reservation", NULL, 0},         // Vaga 2 reservada
+    {5000, STEP_DELIVER, 0, "/parking/batch", batch_reserve, sizeof(batch_reserve)},
+    {5500, STEP_DELIVER, 0, "/parking/batch", batch_too_many, sizeof(batch_too_many)},
+    {6000, STEP_DROP},                                                  // Queda da conexão
+    {6100, STEP_BROKER, false},                                         // Broker fora do ar por alguns segundos
+    {6500, STEP_PRESS, BTN_B_PIN},                                      // Seleciona a vaga 2 (offline)
+    {6900, STEP_DISPLAY, false},                                        // Display sem responder: o envio é abortado
+    {7000, STEP_PRESS, BTN_SW_PIN},                                     // Vaga 2 ocupada (vai para o journal)
+    {8000, STEP_DISPLAY, true},                                         // O próximo redesenho reenvia a tela inteira
+    {9000, STEP_BROKER, true},
+    {10000, STEP_PRESS, BTN_SW_PIN},                                    // Vaga 2 livre de novo (tela inteira reenviada)
+    {29000, STEP_DELIVER, 0, "/trace/dump", NULL, 0},                   // Dump do trace de tudo acima
+    {30000, STEP_DELIVER, 0, "/print", (const uint8_t *)"host", 4},
+    {31000, STEP_DELIVER, 0, "/exit", NULL, 0},
+};
+
+static double sim_seconds(void)
+{
+    return to_us_since_boot(get_absolute_time()) / 1e6;
+}
+
+static void run_step(void *arg)
+{
+    const sim_step_t *step = (const sim_step_t *)arg;
+    switch (step->kind)
+    {
+    case STEP_PRESS:
+        printf("[sim %8.3f] press GPIO %lu\n", sim_seconds(), (unsigned long)step->value);
+        mock_gpio_press(step->value, 100);
+        break;
+    case STEP_DELIVER:
+        printf("[sim %8.3f] deliver %s (%u bytes)\n", sim_seconds(), step->topic, (unsigned)step->len);
+        if (!mock_mqtt_deliver(step->topic, step->payload, step->len))
+            printf("[sim %8.3f] not delivered: client offline or not subscribed\n", sim_seconds());
+        break;
+    case STEP_DROP:
+        printf("[sim %8.3f] drop connection\n", sim_seconds());
+        mock_mqtt_drop_connection();
+        break;
+    case STEP_BROKER:
+        printf("[sim %8.3f] broker %s\n", sim_seconds(), step->value ? "online" : "offline");
+        mock_mqtt_set_broker(step->value);
+        break;
+    case STEP_DISPLAY:
+        printf("[sim %8.3f] display %s\n", sim_seconds(), step->value ? "connected" : "disconnected");
+        mock_i2c_set_nack(SSD1306_I2C_PORT, SSD1306_ADDRESS, !step->value);
+        break;
+    }
+}
+
+static void publish_hook(const char *topic, const uint8_t *payload, size_t len, uint8_t qos, bool retain, void *arg)
+{
+    if (trace_out && strcmp(topic, "/trace") == 0)
+    {
+        for (size_t i = 0; i < len; i++)
+            fprintf(trace_out, "%02x", payload[i]);
+        fputc('\n', trace_out);
+    }
+
+    if (!show_publishes)
+        return;
+
+    printf("[sim %8.3f] publish %s qos %u%s: ", sim_seconds(), topic, qos, retain ? " retain" : "");
+    bool text = true;
+    for (size_t i = 0; i < len && text; i++)
+        text = isprint(payload[i]);
+
+    if (text)
+        printf("\"%.*s\"\n", (int)len, (const char *)payload);
+    else
+    {
+        for (size_t i = 0; i < len && i < 32; i++)
+            printf("%02x", payload[i]);
+        printf("%s (%u bytes)\n", len > 32 ? "..." : "", (unsigned)len);
+    }
+}
+
+static void print_report(void)
+{
+    printf("\n[sim] virtual time %.3f s\n", sim_seconds());
+    printf("[sim] i2c: %llu transactions, %llu bytes, %llu us busy\n", (unsigned long long)mock_bus_stats.i2c_transactions,
+           (unsigned long long)mock_bus_stats.i2c_bytes, (unsigned long long)mock_bus_stats.i2c_busy_us);
+    printf("[sim] pio: %llu words, %llu us busy\n", (unsigned long long)mock_bus_stats.pio_words,
+           (unsigned long long)mock_bus_stats.pio_busy_us);
+    printf("[sim] dma: %llu transfers, %llu words\n", (unsigned long long)mock_bus_stats.dma_transfers,
+           (unsigned long long)mock_bus_stats.dma_words);
+    printf("[sim] gpio writes %llu, pwm writes %llu, irqs %llu, flash erased %llu programmed %llu\n",
+           (unsigned long long)mock_bus_stats.gpio_writes, (unsigned long long)mock_bus_stats.pwm_writes,
+           (unsigned long long)mock_bus_stats.irqs, (unsigned long long)mock_bus_stats.flash_erased,
+           (unsigned long long)mock_bus_stats.flash_programmed);
+    printf("[sim] mqtt: %lu connects, %lu publishes (%lu rejected), %llu bytes (%llu payload), %lu deliveries\n",
+           (unsigned long)mock_mqtt_stats.connects, (unsigned long)mock_mqtt_stats.publishes,
+           (unsigned long)mock_mqtt_stats.publish_rejected, (unsigned long long)mock_mqtt_stats.publish_bytes,
+           (unsigned long long)mock_mqtt_stats.payload_bytes, (unsigned long)mock_mqtt_stats.deliveries);
+    printf("[sim] display: %lu commands, %lu data bytes\n", (unsigned long)oled.commands, (unsigned long)oled.data_bytes);
+
+    if (show_screen)
+        mock_ssd1306_print(&oled, stdout);
+}
+
+int main(int argc, char **argv)
+{
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--screen") == 0)
+            show_screen = true;
+        else if (strcmp(argv[i], "--quiet") == 0)
+            show_publishes = false;
+        else if (strcmp(argv[i], "--trace") == 0 && i + 1 < argc)
+        {
+            trace_out = fopen(argv[++i], "w");
+            if (!trace_out)
+            {
+                perror(argv[i]);
+                return 1;
+            }
+        }
+        else
+        {
+            fprintf(stderr, "usage: %s [--screen] [--quiet] [--trace FILE]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    mock_time_reset();
+    mock_rand_seed(1);
+    mock_time_set_limit(SIM_LIMIT_S * 1000000ull);
+    mock_ssd1306_attach(&oled, SSD1306_I2C_PORT, SSD1306_ADDRESS);
+    mock_mqtt_set_publish_hook(publish_hook, NULL);
+
+    for (size_t i = 0; i < count_of(script); i++)
+        mock_context_schedule(script[i].at_ms * 1000ull, run_step, (void *)&script[i]);
+
+    int result = parking_firmware_main();
+    print_report();
+    if (trace_out)
+        fclose(trace_out);
+    return result;
+}
@@ -1,4 +1,13 @@
 #include "button.h"
+#include "hardware/sync.h"
+
+// Fila SPSC: a interrupção só escreve em event_head e o consumidor só escreve em event_tail
+static button_event_t event_queue[BUTTON_EVENT_QUEUE_SIZE];
+static volatile uint32_t event_head = 0, event_tail = 0;
+static volatile uint32_t event_dropped = 0;
+
+static uint32_t last_accepted_us[BUTTON_MAX_GPIO]; // Último evento aceito por GPIO (debounce)
+static bool has_accepted[BUTTON_MAX_GPIO];
 
 void init_btn(uint8_t pin)
 {
@@ -17,3 +26,52 @@ bool btn_is_pressed(uint8_t pin)
 {
     return !gpio_get(pin); // Retorna verdadeiro se o botão estiver pressionado
 }
+
+// Registra um evento (chamado pela interrupção); se a fila estiver cheia, conta o descarte e retorna false
+bool button_event_push(uint gpio, uint32_t events, uint32_t timestamp_us)
+{
+    uint32_t head = event_head;
+    if (head - event_tail >= BUTTON_EVENT_QUEUE_SIZE)
+    {
+        event_dropped++;
+        return false;
+    }
+
+    event_queue[head % BUTTON_EVENT_QUEUE_SIZE] = (button_event_t){.gpio = gpio, .events = events, .timestamp_us = timestamp_us};
+    __dmb(); // O evento precisa estar escrito antes de ser publicado pelo índice
+    event_head = head + 1;
+    return true;
+}
+
+// Retira o evento mais antigo da fila; retorna false se ela estiver vazia
+bool button_event_pop(button_event_t *event)
+{
+    uint32_t tail = event_tail;
+    if (tail == event_head)
+        return false;
+
+    __dmb(); // Lê o evento só depois de ver o índice publicado pela interrupção
+    *event = event_queue[tail % BUTTON_EVENT_QUEUE_SIZE];
+    event_tail = tail + 1;
+    return true;
+}
+
+// Quantidade de eventos perdidos por fila cheia
+uint32_t button_event_dropped()
+{
+    return event_dropped;
+}
+
+// Debounce pelo carimbo de tempo: aceita o evento se o anterior aceito no mesmo GPIO foi há mais de debounce_us
+bool button_event_accept(const button_event_t *event, uint32_t debounce_us)
+{
+    if (event->gpio >= BUTTON_MAX_GPIO)
+        return false;
+
+    if (has_accepted[event->gpio] && (event->timestamp_us - last_accepted_us[event->gpio]) <= debounce_us)
+        return false;
+
+    has_accepted[event->gpio] = true;
+    last_accepted_us[event->gpio] = event->timestamp_us;
+    return true;
+}
@@ -8,8 +8,24 @@
 #define BTN_B_PIN 6 // GPIO para botão B
 #define BTN_SW_PIN 22 // GPIO para botão do joystick
 
+#define BUTTON_EVENT_QUEUE_SIZE 32 // Eventos aguardando o consumidor (potência de 2)
+#define BUTTON_MAX_GPIO 30         // GPIOs do RP2040
+
+// Evento de entrada registrado pela interrupção
+typedef struct
+{
+    uint8_t gpio;          // GPIO que gerou a interrupção
+    uint32_t events;       // Máscara GPIO_IRQ_* recebida
+    uint32_t timestamp_us; // Momento da borda (time_us_32)
+} button_event_t;
+
 void init_btn(uint8_t pin);
 void init_btns();
 bool btn_is_pressed(uint8_t pin);
 
+bool button_event_push(uint gpio, uint32_t events, uint32_t timestamp_us); // Produtor: interrupção
+bool button_event_pop(button_event_t *event);                             // Consumidor: laço/contexto assíncrono
+uint32_t button_event_dropped();
+bool button_event_accept(const button_event_t *event, uint32_t debounce_us);
+
 #endif // BUTTON_H
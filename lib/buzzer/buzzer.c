@@ -1,10 +1,21 @@
 #include "buzzer.h"
 #include "hardware/pwm.h"
 #include "hardware/clocks.h"
+#include "hardware/sync.h"
+
+static float buzzer_clk_div = 1.0f; // Divisor de clock informado em init_buzzer()
+
+// Fila circular de tons tocados em segundo plano por alarmes de hardware
+static buzzer_tone_t tone_queue[BUZZER_QUEUE_SIZE];
+static volatile uint8_t tone_head = 0, tone_tail = 0;
+static volatile bool tone_playing = false;
+static buzzer_tone_t current_tone;
+static bool current_in_gap = false;
 
 // Inicializa o PWM no pino do buzzer
 int init_buzzer(uint pin, float clk_div)
 {
+    buzzer_clk_div = clk_div;
     gpio_set_function(pin, GPIO_FUNC_PWM);
     uint slice_num = pwm_gpio_to_slice_num(pin);
     pwm_config config = pwm_get_default_config();
@@ -16,12 +27,24 @@ int init_buzzer(uint pin, float clk_div)
 }
 
 // Toca uma nota com a frequência e duração especificadas
+// O período é calculado sobre o clock já dividido por clk_div; se não couber nos 16 bits do contador,
+// o divisor é aumentado apenas para esta nota.
 void play_tone(uint pin, uint frequency)
 {
+    if (frequency == 0)
+    {
+        stop_tone(pin);
+        return;
+    }
+
     uint slice_num = pwm_gpio_to_slice_num(pin);
     uint32_t clock_freq = clock_get_hz(clk_sys);
-    uint32_t top = clock_freq / frequency - 1;
+    float div = buzzer_clk_div;
+    if (clock_freq / (div * frequency) > 65536.0f)
+        div = clock_freq / (65536.0f * frequency);
+    uint32_t top = (uint32_t)(clock_freq / (div * frequency)) - 1;
 
+    pwm_set_clkdiv(slice_num, div);
     pwm_set_wrap(slice_num, top);
     pwm_set_gpio_level(pin, top / 2); // 50% de duty cycle
 }
@@ -29,6 +52,98 @@ void play_tone(uint pin, uint frequency)
 // Desliga o tom no pino do buzzer
 void stop_tone(uint pin)
 {
-    uint slice_num = pwm_gpio_to_slice_num(pin);
     pwm_set_gpio_level(pin, 0); // Desliga o PWM
-}
\ No newline at end of file
+}
+
+// Retira o próximo tom da fila; retorna false se ela estiver vazia
+static bool buzzer_dequeue(buzzer_tone_t *tone)
+{
+    if (tone_tail == tone_head)
+        return false;
+
+    *tone = tone_queue[tone_tail];
+    tone_tail = (tone_tail + 1) % BUZZER_QUEUE_SIZE;
+    return true;
+}
+
+// Sequenciador: alterna entre tocar o tom atual e a pausa que o segue, reagendando o próprio alarme
+static int64_t buzzer_alarm_cb(alarm_id_t id, void *user_data)
+{
+    if (!current_in_gap)
+    {
+        stop_tone(current_tone.pin);
+        if (current_tone.gap_ms > 0)
+        {
+            current_in_gap = true;
+            return (int64_t)current_tone.gap_ms * 1000;
+        }
+    }
+
+    if (!buzzer_dequeue(&current_tone))
+    {
+        tone_playing = false;
+        return 0;
+    }
+
+    current_in_gap = false;
+    play_tone(current_tone.pin, current_tone.frequency);
+    return (int64_t)current_tone.duration_ms * 1000;
+}
+
+// Enfileira um tom (frequência 0 = silêncio) e retorna imediatamente; false se a fila estiver cheia
+// ou o tom não couber nos campos da fila. A duração precisa ser de pelo menos 1 ms: o alarme
+// retornar 0 encerraria o sequenciador com o tom ainda tocando.
+bool buzzer_enqueue(uint pin, uint frequency, uint duration_ms, uint gap_ms)
+{
+    if (pin > UINT8_MAX || frequency > UINT16_MAX || duration_ms == 0 || duration_ms > UINT16_MAX || gap_ms > UINT16_MAX)
+        return false;
+
+    uint32_t irq_state = save_and_disable_interrupts();
+
+    uint8_t next = (tone_head + 1) % BUZZER_QUEUE_SIZE;
+    if (next == tone_tail)
+    {
+        restore_interrupts(irq_state);
+        return false;
+    }
+    tone_queue[tone_head] = (buzzer_tone_t){.pin = pin, .frequency = frequency, .duration_ms = duration_ms, .gap_ms = gap_ms};
+    tone_head = next;
+
+    bool start = !tone_playing;
+    if (start)
+    {
+        tone_playing = true;
+        buzzer_dequeue(&current_tone);
+        current_in_gap = false;
+    }
+    restore_interrupts(irq_state);
+
+    if (start)
+    {
+        play_tone(current_tone.pin, current_tone.frequency);
+        if (add_alarm_in_ms(current_tone.duration_ms, buzzer_alarm_cb, NULL, true) < 0)
+        {
+            // Sem alarmes livres: descarta a sequência para não deixar o buzzer ligado
+            irq_state = save_and_disable_interrupts();
+            stop_tone(current_tone.pin);
+            tone_tail = tone_head;
+            tone_playing = false;
+            restore_interrupts(irq_state);
+        }
+    }
+    return true;
+}
+
+// Descarta os tons que ainda não começaram a tocar
+void buzzer_clear_queue()
+{
+    uint32_t irq_state = save_and_disable_interrupts();
+    tone_tail = tone_head;
+    restore_interrupts(irq_state);
+}
+
+// Indica se o sequenciador está tocando (ou em pausa entre tons)
+bool buzzer_is_playing()
+{
+    return tone_playing;
+}
@@ -7,8 +7,22 @@
 #define BUZZER_A_PIN 21 // GPIO para buzzer A
 #define BUZZER_B_PIN 10 // GPIO para buzzer B
 
+#define BUZZER_QUEUE_SIZE 16 // Tons aguardando na fila do sequenciador
+
+typedef struct
+{
+    uint8_t pin;          // GPIO do buzzer
+    uint16_t frequency;   // Frequência em Hz (0 = silêncio)
+    uint16_t duration_ms; // Duração do tom
+    uint16_t gap_ms;      // Pausa após o tom
+} buzzer_tone_t;
+
 int init_buzzer(uint pin, float clk_div); // Inicializa o PWM no pino do buzzer
 void play_tone(uint pin, uint frequency); // Toca uma nota com a frequência e duração especificadas
 void stop_tone(uint pin);                 // Desliga o tom no pino do buzzer
 
+bool buzzer_enqueue(uint pin, uint frequency, uint duration_ms, uint gap_ms); // Enfileira um tom sem bloquear
+void buzzer_clear_queue();                                                  // Descarta os tons pendentes
+bool buzzer_is_playing();                                                   // Sequenciador ativo
+
 #endif // BUZZER_H
@@ -0,0 +1,80 @@
+#include <stdarg.h>
+#include <string.h>
+#include <stdio.h>
+#include "log.h"
+
+log_buffer_t log_buffer;
+
+void log_write(const char *format, ...)
+{
+    char line[LOG_LINE_MAX];
+    va_list args;
+    va_start(args, format);
+    int len = vsnprintf(line, sizeof(line), format, args);
+    va_end(args);
+    if (len <= 0)
+        return;
+    if (len >= (int)sizeof(line))
+    {
+        len = sizeof(line) - 1;
+        line[len - 1] = '\n'; // Mensagem cortada continua terminando a linha
+    }
+
+    // O Cortex-M0+ não tem instruções atômicas: a reserva e a cópia são feitas com as interrupções
+    // desligadas, por no máximo LOG_LINE_MAX bytes. O escoamento só lê o buffer e avança tail.
+    uint32_t irq_state = save_and_disable_interrupts();
+    uint32_t head = log_buffer.head;
+    if (LOG_BUFFER_BYTES - (head - log_buffer.tail) < (uint32_t)len)
+    {
+        log_buffer.dropped++;
+        restore_interrupts(irq_state);
+        return;
+    }
+
+    uint32_t start = head % LOG_BUFFER_BYTES;
+    uint32_t first = LOG_BUFFER_BYTES - start < (uint32_t)len ? LOG_BUFFER_BYTES - start : (uint32_t)len;
+    memcpy(&log_buffer.data[start], line, first);
+    memcpy(log_buffer.data, line + first, len - first);
+    log_buffer.head = head + len;
+    restore_interrupts(irq_state);
+}
+
+size_t log_drain(size_t max_bytes)
+{
+    uint32_t dropped = log_buffer.dropped;
+    if (dropped != log_buffer.reported)
+    {
+        printf("[log] %lu messages dropped\n", (unsigned long)(dropped - log_buffer.reported));
+        log_buffer.reported = dropped;
+    }
+
+    size_t written = 0;
+    uint32_t tail = log_buffer.tail;
+    uint32_t available = log_buffer.head - tail;
+    while (available > 0 && written < max_bytes)
+    {
+        uint32_t start = tail % LOG_BUFFER_BYTES;
+        uint32_t chunk = LOG_BUFFER_BYTES - start;
+        if (chunk > available)
+            chunk = available;
+        if (chunk > max_bytes - written)
+            chunk = max_bytes - written;
+
+        printf("%.*s", (int)chunk, &log_buffer.data[start]);
+        tail += chunk;
+        log_buffer.tail = tail; // Libera o espaço já escrito para novas mensagens
+        available -= chunk;
+        written += chunk;
+    }
+    return written;
+}
+
+bool log_pending(void)
+{
+    return log_buffer.head != log_buffer.tail || log_buffer.dropped != log_buffer.reported;
+}
+
+uint32_t log_dropped(void)
+{
+    return log_buffer.dropped;
+}
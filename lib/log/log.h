@@ -0,0 +1,71 @@
+#ifndef LOG_H
+#define LOG_H
+
+#include <stdlib.h>
+#include "pico/stdlib.h"
+#include "hardware/sync.h"
+
+// Log adiado: as mensagens são formatadas em um buffer circular na RAM e escritas no stdio só
+// quando o loop principal fica ocioso, então um host lento na USB não atrasa quem registrou.
+// Com o buffer cheio a mensagem é descartada e contada, nunca esperada.
+
+#define LOG_LEVEL_ERROR 0
+#define LOG_LEVEL_WARN 1
+#define LOG_LEVEL_INFO 2
+#define LOG_LEVEL_DEBUG 3
+
+// Mensagens acima deste nível são removidas na compilação
+#ifndef LOG_LEVEL
+#ifndef NDEBUG
+#define LOG_LEVEL LOG_LEVEL_DEBUG
+#else
+#define LOG_LEVEL LOG_LEVEL_INFO
+#endif
+#endif
+
+#ifndef LOG_BUFFER_BYTES
+#define LOG_BUFFER_BYTES 2048 // Texto guardado até o próximo escoamento (potência de 2)
+#endif
+
+#ifndef LOG_LINE_MAX
+#define LOG_LINE_MAX 128 // Maior mensagem; o excesso é cortado
+#endif
+
+#ifndef LOG_DRAIN_BYTES
+#define LOG_DRAIN_BYTES 256 // Bytes escritos a cada volta ociosa do loop
+#endif
+
+typedef struct
+{
+    char data[LOG_BUFFER_BYTES];
+    volatile uint32_t head; // Bytes gravados desde o início (só quem registra avança)
+    volatile uint32_t tail; // Bytes escritos no stdio (só o escoamento avança)
+    uint32_t dropped;       // Mensagens descartadas com o buffer cheio
+    uint32_t reported;      // Descartes já avisados no stdio
+} log_buffer_t;
+
+extern log_buffer_t log_buffer;
+
+// Formata e guarda uma mensagem; pode ser chamada de interrupções
+void log_write(const char *format, ...) __attribute__((format(printf, 1, 2)));
+
+// O nível é constante: abaixo do limite o compilador remove a chamada e a string,
+// mas os argumentos continuam sendo verificados
+#define LOG_AT(level, ...)                 \
+    do                                     \
+    {                                      \
+        if ((level) <= LOG_LEVEL)          \
+            log_write(__VA_ARGS__);        \
+    } while (0)
+
+#define LOG_ERROR(...) LOG_AT(LOG_LEVEL_ERROR, __VA_ARGS__)
+#define LOG_WARN(...) LOG_AT(LOG_LEVEL_WARN, __VA_ARGS__)
+#define LOG_INFO(...) LOG_AT(LOG_LEVEL_INFO, __VA_ARGS__)
+#define LOG_DEBUG(...) LOG_AT(LOG_LEVEL_DEBUG, __VA_ARGS__)
+
+// Escreve no stdio até max_bytes do que está guardado, avisando antes dos descartes; retorna os bytes escritos
+size_t log_drain(size_t max_bytes);
+bool log_pending(void);
+uint32_t log_dropped(void);
+
+#endif // LOG_H
@@ -0,0 +1,47 @@
+#include "latency_histogram.h"
+
+static uint8_t *histogram_put_u32(uint8_t *p, uint32_t value)
+{
+    *p++ = value >> 24;
+    *p++ = value >> 16;
+    *p++ = value >> 8;
+    *p++ = value;
+    return p;
+}
+
+// Quantidade de bits significativos, limitada ao último bucket
+uint8_t latency_histogram_bucket(uint32_t us)
+{
+    uint8_t bits = us ? 32 - __builtin_clz(us) : 0;
+    return bits < LATENCY_HISTOGRAM_BUCKETS ? bits : LATENCY_HISTOGRAM_BUCKETS - 1;
+}
+
+void latency_histogram_record(latency_histogram_t *histogram, uint32_t us)
+{
+    histogram->count++;
+    histogram->sum_us += us;
+    if (us > histogram->max_us)
+        histogram->max_us = us;
+    histogram->buckets[latency_histogram_bucket(us)]++;
+}
+
+// Só os buckets não vazios são enviados
+size_t latency_histogram_encode(const latency_histogram_t *histogram, uint8_t id, uint8_t *buffer)
+{
+    uint32_t mask = 0;
+    for (uint8_t i = 0; i < LATENCY_HISTOGRAM_BUCKETS; i++)
+        if (histogram->buckets[i])
+            mask |= 1u << i;
+
+    uint8_t *p = buffer;
+    *p++ = id;
+    p = histogram_put_u32(p, histogram->count);
+    p = histogram_put_u32(p, histogram->max_us);
+    p = histogram_put_u32(p, histogram->sum_us >> 32);
+    p = histogram_put_u32(p, histogram->sum_us);
+    p = histogram_put_u32(p, mask);
+    for (uint8_t i = 0; i < LATENCY_HISTOGRAM_BUCKETS; i++)
+        if (mask & (1u << i))
+            p = histogram_put_u32(p, histogram->buckets[i]);
+    return p - buffer;
+}
@@ -0,0 +1,28 @@
+#ifndef LATENCY_HISTOGRAM_H
+#define LATENCY_HISTOGRAM_H
+
+#include "pico/stdlib.h"
+
+// Histograma de latências em escala logarítmica (base 2), em microssegundos:
+// o bucket i conta os valores com i bits significativos (0 = 0 us, 1 = 1 us, 2 = 2-3 us, 3 = 4-7 us, ...),
+// e o último acumula tudo a partir de 2^(LATENCY_HISTOGRAM_BUCKETS - 2) us (~4,2 s)
+#define LATENCY_HISTOGRAM_BUCKETS 24
+
+// Histograma codificado (inteiros em big-endian):
+//   id (1 byte), quantidade (4), maior valor em us (4), soma em us (8),
+//   máscara dos buckets não vazios (4, bit i = bucket i) e a contagem de cada um deles (4 cada)
+#define LATENCY_HISTOGRAM_MAX_BYTES (1 + 4 + 4 + 8 + 4 + 4 * LATENCY_HISTOGRAM_BUCKETS)
+
+typedef struct
+{
+    uint32_t count;
+    uint32_t max_us;
+    uint64_t sum_us;
+    uint32_t buckets[LATENCY_HISTOGRAM_BUCKETS];
+} latency_histogram_t;
+
+void latency_histogram_record(latency_histogram_t *histogram, uint32_t us); // Tempo constante; não é atômica (64 bits na soma)
+uint8_t latency_histogram_bucket(uint32_t us);
+size_t latency_histogram_encode(const latency_histogram_t *histogram, uint8_t id, uint8_t *buffer); // Retorna o tamanho
+
+#endif // LATENCY_HISTOGRAM_H
@@ -0,0 +1,67 @@
+#include "payload_assembler.h"
+#include <string.h>
+
+void payload_assembler_init(payload_assembler_t *assembler, uint8_t *buffer, uint16_t capacity)
+{
+    memset(assembler, 0, sizeof(*assembler));
+    assembler->buffer = buffer;
+    assembler->capacity = capacity;
+}
+
+// Nova mensagem: mensagens montadas em buffer são limitadas também pela capacidade dele
+void payload_assembler_begin(payload_assembler_t *assembler, uint32_t total_len, uint32_t max_len, bool stream)
+{
+    if (!stream && max_len > assembler->capacity)
+        max_len = assembler->capacity;
+
+    assembler->expected = total_len;
+    assembler->received = 0;
+    assembler->stream = stream;
+    assembler->rejected = total_len > max_len;
+}
+
+// Processa um fragmento. Uma mensagem de fragmento único é entregue sem cópia; as demais são copiadas
+// para o buffer (com limite) ou, em modo streaming, entregues fragmento a fragmento com PAYLOAD_FLAG_FIRST
+// e PAYLOAD_FLAG_LAST em *flags
+payload_result_t payload_assembler_feed(payload_assembler_t *assembler, const uint8_t *data, uint16_t len, uint8_t *flags,
+                                        const uint8_t **payload, uint32_t *payload_len)
+{
+    bool first = assembler->received == 0;
+    bool last = *flags & PAYLOAD_FLAG_LAST;
+
+    // Mais dados que o anunciado: descarta o resto da mensagem
+    if (assembler->received + len > assembler->expected)
+        assembler->rejected = true;
+    assembler->received += len;
+
+    if (assembler->rejected)
+    {
+        if (!last)
+            return PAYLOAD_PENDING;
+        assembler->rejected_count++;
+        return PAYLOAD_REJECTED;
+    }
+
+    if (assembler->stream)
+    {
+        *flags |= first ? PAYLOAD_FLAG_FIRST : 0;
+        *payload = data;
+        *payload_len = len;
+        return PAYLOAD_CHUNK;
+    }
+
+    if (first && last)
+    {
+        *payload = data;
+        *payload_len = len;
+        return PAYLOAD_COMPLETE;
+    }
+
+    memcpy(&assembler->buffer[assembler->received - len], data, len); // expected <= capacity
+    if (!last)
+        return PAYLOAD_PENDING;
+
+    *payload = assembler->buffer;
+    *payload_len = assembler->received;
+    return PAYLOAD_COMPLETE;
+}
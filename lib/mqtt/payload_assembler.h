@@ -0,0 +1,35 @@
+#ifndef PAYLOAD_ASSEMBLER_H
+#define PAYLOAD_ASSEMBLER_H
+
+#include <stdlib.h>
+#include "pico/stdlib.h"
+
+#define PAYLOAD_FLAG_LAST 0x01  // Igual a MQTT_DATA_FLAG_LAST
+#define PAYLOAD_FLAG_FIRST 0x80 // Primeiro fragmento da mensagem (modo streaming)
+
+typedef enum
+{
+    PAYLOAD_PENDING,  // Aguardando mais fragmentos
+    PAYLOAD_CHUNK,    // Streaming: fragmento pronto para o tratador
+    PAYLOAD_COMPLETE, // Mensagem completa pronta para o tratador
+    PAYLOAD_REJECTED, // Mensagem descartada (maior que o limite); informado uma única vez, no último fragmento
+} payload_result_t;
+
+// Monta o payload de uma mensagem a partir dos fragmentos entregues pelo cliente MQTT
+typedef struct
+{
+    uint8_t *buffer;   // Área para mensagens fragmentadas
+    uint16_t capacity; // Tamanho de buffer
+    uint32_t expected; // Tamanho total anunciado pelo cabeçalho PUBLISH
+    uint32_t received; // Bytes recebidos até agora
+    bool stream;       // Fragmentos vão direto ao tratador, sem montagem
+    bool rejected;
+    uint32_t rejected_count; // Mensagens descartadas desde o boot
+} payload_assembler_t;
+
+void payload_assembler_init(payload_assembler_t *assembler, uint8_t *buffer, uint16_t capacity);
+void payload_assembler_begin(payload_assembler_t *assembler, uint32_t total_len, uint32_t max_len, bool stream);
+payload_result_t payload_assembler_feed(payload_assembler_t *assembler, const uint8_t *data, uint16_t len, uint8_t *flags,
+                                        const uint8_t **payload, uint32_t *payload_len);
+
+#endif // PAYLOAD_ASSEMBLER_H
@@ -0,0 +1,125 @@
+#include "publish_queue.h"
+#include <string.h>
+
+static inline publish_message_t *queue_at(publish_queue_t *queue, uint8_t i)
+{
+    return &queue->messages[(queue->head + i) % PUBLISH_QUEUE_SIZE];
+}
+
+// Remove a mensagem na posição i, mantendo a ordem das demais
+static void queue_remove(publish_queue_t *queue, uint8_t i)
+{
+    for (; i + 1 < queue->count; i++)
+        *queue_at(queue, i) = *queue_at(queue, i + 1);
+    queue->count--;
+}
+
+// Fim de uma requisição da fila: contabiliza falhas e avisa que há espaço livre
+static void publish_queue_request_cb(void *arg, err_t err)
+{
+    publish_queue_t *queue = (publish_queue_t *)arg;
+    if (err != ERR_OK)
+        queue->stats.failed++;
+
+    if (queue->slot_freed)
+        queue->slot_freed(queue->slot_freed_arg);
+}
+
+void publish_queue_init(publish_queue_t *queue, mqtt_client_t *client, void (*slot_freed)(void *arg), void *arg)
+{
+    memset(queue, 0, sizeof(*queue));
+    queue->client = client;
+    queue->slot_freed = slot_freed;
+    queue->slot_freed_arg = arg;
+}
+
+// Enfileira uma mensagem; se já houver uma com a mesma chave, ela é atualizada no lugar (mantém a ordem)
+bool publish_queue_push(publish_queue_t *queue, uint16_t key, const char *topic, const void *payload, uint8_t len,
+                        uint8_t qos, bool retain)
+{
+    publish_message_t *message = NULL;
+    bool kept = true;
+
+    if (len > PUBLISH_QUEUE_PAYLOAD_LEN || strlen(topic) >= PUBLISH_QUEUE_TOPIC_LEN)
+    {
+        queue->stats.dropped++;
+        return false;
+    }
+
+    if (key != PUBLISH_QUEUE_NO_KEY)
+    {
+        for (uint8_t i = 0; i < queue->count; i++)
+        {
+            if (queue_at(queue, i)->key == key)
+            {
+                message = queue_at(queue, i);
+                queue->stats.collapsed++;
+                break;
+            }
+        }
+    }
+
+    if (!message)
+    {
+        // Fila cheia: descarta a mensagem sem chave mais antiga (ou a mais antiga de todas), preservando
+        // o último estado de cada chave
+        if (queue->count == PUBLISH_QUEUE_SIZE)
+        {
+            uint8_t victim = 0;
+            for (uint8_t i = 0; i < queue->count; i++)
+            {
+                if (queue_at(queue, i)->key == PUBLISH_QUEUE_NO_KEY)
+                {
+                    victim = i;
+                    break;
+                }
+            }
+            queue_remove(queue, victim);
+            queue->stats.dropped++;
+            kept = false;
+        }
+        message = queue_at(queue, queue->count++);
+        if (queue->count > queue->stats.max_depth)
+            queue->stats.max_depth = queue->count;
+    }
+
+    message->key = key;
+    message->qos = qos;
+    message->retain = retain;
+    message->len = len;
+    strcpy(message->topic, topic);
+    memcpy(message->payload, payload, len);
+    queue->stats.queued++;
+    return kept;
+}
+
+// Envia as mensagens em ordem; a primeira recusa interrompe e ela é tentada de novo no próximo flush
+void publish_queue_flush(publish_queue_t *queue)
+{
+    while (queue->count)
+    {
+        publish_message_t *message = queue_at(queue, 0);
+        err_t err = mqtt_publish(queue->client, message->topic, message->payload, message->len, message->qos,
+                                 message->retain, publish_queue_request_cb, queue);
+        if (err != ERR_OK)
+        {
+            queue->stats.retries++;
+            return;
+        }
+
+        queue->head = (queue->head + 1) % PUBLISH_QUEUE_SIZE;
+        queue->count--;
+        queue->stats.sent++;
+    }
+}
+
+uint16_t publish_queue_depth(const publish_queue_t *queue)
+{
+    return queue->count;
+}
+
+void publish_queue_clear(publish_queue_t *queue)
+{
+    queue->head = 0;
+    queue->count = 0;
+}
@@ -0,0 +1,55 @@
+#ifndef PUBLISH_QUEUE_H
+#define PUBLISH_QUEUE_H
+
+#include <stdlib.h>
+#include "pico/stdlib.h"
+#include "lwip/apps/mqtt.h"
+
+#define PUBLISH_QUEUE_SIZE 8         // Mensagens aguardando espaço no cliente MQTT
+#define PUBLISH_QUEUE_TOPIC_LEN 64   // Tamanho máximo do tópico de uma mensagem enfileirada
+#define PUBLISH_QUEUE_PAYLOAD_LEN 24 // Tamanho máximo do payload de uma mensagem enfileirada
+#define PUBLISH_QUEUE_NO_KEY 0       // Mensagens sem chave nunca substituem outras
+
+// Mensagem aguardando envio
+typedef struct
+{
+    uint16_t key; // Mensagens com a mesma chave se substituem (vale o estado mais recente)
+    uint8_t qos;
+    bool retain;
+    uint8_t len;
+    char topic[PUBLISH_QUEUE_TOPIC_LEN];
+    uint8_t payload[PUBLISH_QUEUE_PAYLOAD_LEN];
+} publish_message_t;
+
+// Métricas da fila
+typedef struct
+{
+    uint32_t queued;    // Mensagens aceitas
+    uint32_t collapsed; // Mensagens substituídas por uma mais recente com a mesma chave
+    uint32_t dropped;   // Mensagens descartadas com a fila cheia
+    uint32_t retries;   // Envios recusados pelo cliente (sem requisições livres ou buffer cheio)
+    uint32_t sent;      // Mensagens entregues ao cliente MQTT
+    uint32_t failed;    // Mensagens sem confirmação do broker
+    uint16_t max_depth; // Maior ocupação observada
+} publish_queue_stats_t;
+
+// Fila circular de publicações; envia em ordem e para na primeira recusa do cliente
+typedef struct
+{
+    mqtt_client_t *client;
+    publish_message_t messages[PUBLISH_QUEUE_SIZE];
+    uint8_t head;
+    uint8_t count;
+    publish_queue_stats_t stats;
+    void (*slot_freed)(void *arg); // Chamada quando uma requisição termina e libera espaço
+    void *slot_freed_arg;
+} publish_queue_t;
+
+void publish_queue_init(publish_queue_t *queue, mqtt_client_t *client, void (*slot_freed)(void *arg), void *arg);
+bool publish_queue_push(publish_queue_t *queue, uint16_t key, const char *topic, const void *payload, uint8_t len,
+                        uint8_t qos, bool retain); // false se descartou uma mensagem para abrir espaço
+void publish_queue_flush(publish_queue_t *queue);   // Envia até o cliente recusar
+uint16_t publish_queue_depth(const publish_queue_t *queue);
+void publish_queue_clear(publish_queue_t *queue);
+
+#endif // PUBLISH_QUEUE_H
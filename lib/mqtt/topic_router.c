@@ -0,0 +1,150 @@
+#include "topic_router.h"
+
+// Compara um segmento do tópico com o de um nó, sem depender de terminador
+static bool segment_equals(const topic_node_t *node, const char *segment, uint8_t len)
+{
+    if (node->segment_len != len)
+        return false;
+
+    for (uint8_t i = 0; i < len; i++)
+    {
+        if (node->segment[i] != segment[i])
+            return false;
+    }
+    return true;
+}
+
+// Tamanho do segmento que começa em "segment" (até '/' ou fim); o chamador rejeita acima de UINT8_MAX
+static size_t segment_length(const char *segment)
+{
+    size_t len = 0;
+    while (segment[len] && segment[len] != '/')
+        len++;
+    return len;
+}
+
+static int8_t router_new_node(topic_router_t *router, const char *segment, uint8_t len)
+{
+    if (router->node_count == TOPIC_ROUTER_MAX_NODES)
+        return TOPIC_ROUTER_NONE;
+
+    topic_node_t *node = &router->nodes[router->node_count];
+    node->segment = segment;
+    node->segment_len = len;
+    node->child = node->sibling = node->wildcard = node->route = TOPIC_ROUTER_NONE;
+    return router->node_count++;
+}
+
+// Filho do nó para o segmento (criado se não existir)
+static int8_t router_child(topic_router_t *router, int8_t parent, const char *segment, uint8_t len)
+{
+    topic_node_t *node = &router->nodes[parent];
+
+    if (len == 1 && segment[0] == '+')
+    {
+        if (node->wildcard == TOPIC_ROUTER_NONE)
+            node->wildcard = router_new_node(router, segment, len);
+        return node->wildcard;
+    }
+
+    for (int8_t i = node->child; i != TOPIC_ROUTER_NONE; i = router->nodes[i].sibling)
+    {
+        if (segment_equals(&router->nodes[i], segment, len))
+            return i;
+    }
+
+    int8_t child = router_new_node(router, segment, len);
+    if (child != TOPIC_ROUTER_NONE)
+    {
+        router->nodes[child].sibling = node->child;
+        router->nodes[parent].child = child;
+    }
+    return child;
+}
+
+// Monta a árvore de segmentos com todos os padrões; padrões repetidos ficam com a primeira rota
+bool topic_router_init(topic_router_t *router, const topic_route_t *routes, uint8_t count)
+{
+    router->routes = routes;
+    router->route_count = count;
+    router->node_count = 0;
+    router_new_node(router, "", 0); // Raiz
+
+    for (uint8_t r = 0; r < count; r++)
+    {
+        const char *p = routes[r].pattern;
+        int8_t node = 0;
+
+        while (true)
+        {
+            size_t len = segment_length(p);
+            if (len > UINT8_MAX)
+                return false;
+
+            node = router_child(router, node, p, len);
+            if (node == TOPIC_ROUTER_NONE)
+                return false;
+
+            p += len;
+            if (*p == '\0')
+                break;
+            p++; // '/'
+        }
+
+        if (router->nodes[node].route == TOPIC_ROUTER_NONE)
+            router->nodes[node].route = r;
+    }
+    return true;
+}
+
+// Percorre o tópico uma única vez; segmentos literais têm prioridade sobre "+", que só aceita inteiros
+const topic_route_t *topic_router_match(const topic_router_t *router, const char *topic, int32_t *params)
+{
+    uint8_t param_count = 0;
+    int8_t node = 0;
+
+    while (true)
+    {
+        size_t len = segment_length(topic);
+        if (len > UINT8_MAX)
+            return NULL;
+
+        const topic_node_t *current = &router->nodes[node];
+        int8_t next = TOPIC_ROUTER_NONE;
+
+        for (int8_t i = current->child; i != TOPIC_ROUTER_NONE; i = router->nodes[i].sibling)
+        {
+            if (segment_equals(&router->nodes[i], topic, len))
+            {
+                next = i;
+                break;
+            }
+        }
+
+        if (next == TOPIC_ROUTER_NONE && current->wildcard != TOPIC_ROUTER_NONE && len > 0 && param_count < TOPIC_ROUTER_MAX_PARAMS)
+        {
+            int32_t value = 0;
+            uint8_t i = 0;
+            while (i < len && topic[i] >= '0' && topic[i] <= '9' && value < 100000000)
+                value = value * 10 + (topic[i++] - '0');
+
+            if (i == len)
+            {
+                params[param_count++] = value;
+                next = current->wildcard;
+            }
+        }
+
+        if (next == TOPIC_ROUTER_NONE)
+            return NULL;
+
+        node = next;
+        topic += len;
+        if (*topic == '\0')
+            break;
+        topic++; // '/'
+    }
+
+    int8_t route = router->nodes[node].route;
+    return route == TOPIC_ROUTER_NONE ? NULL : &router->routes[route];
+}
@@ -0,0 +1,47 @@
+#ifndef TOPIC_ROUTER_H
+#define TOPIC_ROUTER_H
+
+#include <stdlib.h>
+#include "pico/stdlib.h"
+
+#define TOPIC_ROUTER_MAX_NODES 32  // Segmentos distintos somando todos os padrões
+#define TOPIC_ROUTER_MAX_PARAMS 4  // Curingas "+" por padrão
+#define TOPIC_ROUTER_NONE (-1)
+
+// Tratador de um tópico: params traz, em ordem, o valor inteiro de cada "+" do padrão.
+// Em rotas de streaming cada chamada recebe um fragmento, com PAYLOAD_FLAG_FIRST/PAYLOAD_FLAG_LAST em flags
+typedef void (*topic_handler_t)(void *arg, const int32_t *params, const uint8_t *data, uint16_t len, uint8_t flags);
+
+// Padrão de tópico ("/parking/+/reservation") e seu tratador
+typedef struct
+{
+    const char *pattern;
+    topic_handler_t handler;
+    uint32_t max_len; // Maior payload aceito; mensagens maiores são descartadas
+    bool stream;      // Entrega os fragmentos conforme chegam, sem montar a mensagem
+} topic_route_t;
+
+// Nó da árvore de segmentos
+typedef struct
+{
+    const char *segment; // Aponta para dentro do padrão (não é terminado em '\0')
+    uint8_t segment_len;
+    int8_t child;    // Primeiro filho literal
+    int8_t sibling;  // Próximo irmão literal
+    int8_t wildcard; // Filho "+"
+    int8_t route;    // Rota que termina neste nó
+} topic_node_t;
+
+// Árvore montada uma única vez a partir da tabela de rotas
+typedef struct
+{
+    const topic_route_t *routes;
+    uint8_t route_count;
+    topic_node_t nodes[TOPIC_ROUTER_MAX_NODES];
+    uint8_t node_count;
+} topic_router_t;
+
+bool topic_router_init(topic_router_t *router, const topic_route_t *routes, uint8_t count); // false se faltar nó
+const topic_route_t *topic_router_match(const topic_router_t *router, const char *topic, int32_t *params);
+
+#endif // TOPIC_ROUTER_H
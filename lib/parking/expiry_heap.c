@@ -0,0 +1,158 @@
+#include "expiry_heap.h"
+
+static inline bool expiry_before(const expiry_entry_t *a, const expiry_entry_t *b)
+{
+    return absolute_time_diff_us(b->deadline, a->deadline) < 0;
+}
+
+// Posição inicial da vaga na tabela (hash multiplicativo)
+static inline uint16_t expiry_hash(const expiry_heap_t *heap, uint16_t lot)
+{
+    return ((lot * 2654435761u) >> 16) & heap->slot_mask;
+}
+
+// Posição da vaga na tabela ou, se ela não tiver prazo, a posição livre onde entraria
+static uint16_t expiry_find(const expiry_heap_t *heap, uint16_t lot)
+{
+    uint16_t slot = expiry_hash(heap, lot);
+    while (heap->slots[slot].index && heap->slots[slot].lot != lot)
+        slot = (slot + 1) & heap->slot_mask;
+    return slot;
+}
+
+// Libera uma posição da tabela puxando para trás as entradas seguintes da mesma sequência (sem marcadores de remoção)
+static void expiry_slot_remove(expiry_heap_t *heap, uint16_t hole)
+{
+    for (uint16_t next = (hole + 1) & heap->slot_mask; heap->slots[next].index; next = (next + 1) & heap->slot_mask)
+    {
+        uint16_t home = expiry_hash(heap, heap->slots[next].lot);
+        if (((next - home) & heap->slot_mask) >= ((next - hole) & heap->slot_mask))
+        {
+            heap->slots[hole] = heap->slots[next];
+            hole = next;
+        }
+    }
+    heap->slots[hole].index = 0;
+}
+
+static inline void expiry_place(expiry_heap_t *heap, uint16_t index, expiry_entry_t entry)
+{
+    heap->entries[index] = entry;
+    heap->slots[expiry_find(heap, entry.lot)].index = index + 1;
+}
+
+// Sobe a entrada até a posição correta
+static void expiry_sift_up(expiry_heap_t *heap, uint16_t index)
+{
+    expiry_entry_t entry = heap->entries[index];
+    while (index > 0)
+    {
+        uint16_t parent = (index - 1) / 2;
+        if (!expiry_before(&entry, &heap->entries[parent]))
+            break;
+        expiry_place(heap, index, heap->entries[parent]);
+        index = parent;
+    }
+    expiry_place(heap, index, entry);
+}
+
+// Desce a entrada até a posição correta
+static void expiry_sift_down(expiry_heap_t *heap, uint16_t index)
+{
+    expiry_entry_t entry = heap->entries[index];
+    for (;;)
+    {
+        uint32_t child = 2u * index + 1;
+        if (child >= heap->count)
+            break;
+        if (child + 1 < heap->count && expiry_before(&heap->entries[child + 1], &heap->entries[child]))
+            child++;
+        if (!expiry_before(&heap->entries[child], &entry))
+            break;
+        expiry_place(heap, index, heap->entries[child]);
+        index = child;
+    }
+    expiry_place(heap, index, entry);
+}
+
+// Remove a entrada na posição index, preenchendo o buraco com a última
+static void expiry_remove_at(expiry_heap_t *heap, uint16_t index)
+{
+    expiry_slot_remove(heap, expiry_find(heap, heap->entries[index].lot));
+    heap->count--;
+    if (index == heap->count)
+        return;
+
+    expiry_place(heap, index, heap->entries[heap->count]);
+    if (index > 0 && expiry_before(&heap->entries[index], &heap->entries[(index - 1) / 2]))
+        expiry_sift_up(heap, index);
+    else
+        expiry_sift_down(heap, index);
+}
+
+// Insere o prazo da vaga ou reagenda o prazo existente; false se a vaga for inválida ou a heap estiver cheia
+bool expiry_heap_schedule(expiry_heap_t *heap, uint16_t lot, absolute_time_t deadline)
+{
+    if (lot >= heap->lots)
+        return false;
+
+    expiry_slot_t *slot = &heap->slots[expiry_find(heap, lot)];
+    if (slot->index)
+    {
+        uint16_t index = slot->index - 1;
+        bool earlier = absolute_time_diff_us(heap->entries[index].deadline, deadline) < 0;
+        heap->entries[index].deadline = deadline;
+        if (earlier)
+            expiry_sift_up(heap, index);
+        else
+            expiry_sift_down(heap, index);
+        return true;
+    }
+
+    if (heap->count >= heap->capacity)
+        return false;
+
+    slot->lot = lot;
+    heap->entries[heap->count] = (expiry_entry_t){.deadline = deadline, .lot = lot};
+    expiry_sift_up(heap, heap->count++); // Grava a posição no índice
+    return true;
+}
+
+// Remove o prazo da vaga; false se ela não tinha prazo
+bool expiry_heap_cancel(expiry_heap_t *heap, uint16_t lot)
+{
+    if (lot >= heap->lots)
+        return false;
+
+    uint16_t index = heap->slots[expiry_find(heap, lot)].index;
+    if (!index)
+        return false;
+    expiry_remove_at(heap, index - 1);
+    return true;
+}
+
+bool expiry_heap_contains(const expiry_heap_t *heap, uint16_t lot)
+{
+    return lot < heap->lots && heap->slots[expiry_find(heap, lot)].index != 0;
+}
+
+// Prazo mais próximo; false se a heap estiver vazia
+bool expiry_heap_peek(const expiry_heap_t *heap, absolute_time_t *deadline)
+{
+    if (heap->count == 0)
+        return false;
+
+    *deadline = heap->entries[0].deadline;
+    return true;
+}
+
+// Retira a vaga com o prazo mais próximo se ele já venceu em "now"; custo O(log n) por vaga expirada
+bool expiry_heap_pop_expired(expiry_heap_t *heap, absolute_time_t now, uint16_t *lot)
+{
+    if (heap->count == 0 || absolute_time_diff_us(now, heap->entries[0].deadline) > 0)
+        return false;
+
+    *lot = heap->entries[0].lot;
+    expiry_remove_at(heap, 0);
+    return true;
+}
@@ -0,0 +1,59 @@
+#ifndef EXPIRY_HEAP_H
+#define EXPIRY_HEAP_H
+
+#include <stdlib.h>
+#include "pico/stdlib.h"
+
+// Prazo de expiração de uma vaga
+typedef struct
+{
+    absolute_time_t deadline; // Momento em que a reserva expira
+    uint16_t lot;             // Índice da vaga (0 .. lots - 1)
+} expiry_entry_t;
+
+// Posição de uma vaga na heap, em uma tabela hash de endereçamento aberto (sondagem linear)
+typedef struct
+{
+    uint16_t lot;
+    uint16_t index; // Posição + 1 na heap (0 = posição da tabela livre)
+} expiry_slot_t;
+
+// Posições da tabela para "capacity" prazos: potência de 2 com ocupação de no máximo 50%
+#define EXPIRY_HEAP_SLOTS(capacity)                                                                            \
+    ((capacity) <= 4 ? 8 : (capacity) <= 8 ? 16 : (capacity) <= 16 ? 32 : (capacity) <= 32 ? 64                \
+     : (capacity) <= 64 ? 128 : (capacity) <= 128 ? 256 : (capacity) <= 256 ? 512 : (capacity) <= 512 ? 1024 \
+     : (capacity) <= 1024 ? 2048 : (capacity) <= 2048 ? 4096 : (capacity) <= 4096 ? 8192 : 16384)
+
+// Min-heap de prazos ordenada por deadline, com índice vaga -> posição para cancelar/reagendar em O(log n).
+// Heap e índice são dimensionados pelos prazos simultâneos, não pela quantidade de vagas
+typedef struct
+{
+    expiry_entry_t *entries; // Heap (entries[0] é o prazo mais próximo)
+    expiry_slot_t *slots;    // Índice vaga -> posição na heap
+    uint16_t slot_mask;      // Posições da tabela - 1
+    uint16_t capacity;       // Máximo de prazos simultâneos (até 8192)
+    uint16_t lots;           // Vagas válidas (0 .. lots - 1)
+    uint16_t count;          // Prazos na heap
+} expiry_heap_t;
+
+// Declara uma heap com armazenamento estático para "lots" vagas e até "capacity" prazos simultâneos
+#define EXPIRY_HEAP_DEFINE(name, lots_, capacity_)                         \
+    _Static_assert((capacity_) <= 8192, "expiry heap capacity too large"); \
+    static expiry_entry_t name##_entries[capacity_];                       \
+    static expiry_slot_t name##_slots[EXPIRY_HEAP_SLOTS(capacity_)];       \
+    static expiry_heap_t name = {                                          \
+        .entries = name##_entries,                                         \
+        .slots = name##_slots,                                             \
+        .slot_mask = EXPIRY_HEAP_SLOTS(capacity_) - 1,                     \
+        .capacity = (capacity_),                                           \
+        .lots = (lots_),                                                   \
+        .count = 0,                                                        \
+    }
+
+bool expiry_heap_schedule(expiry_heap_t *heap, uint16_t lot, absolute_time_t deadline); // Insere ou reagenda
+bool expiry_heap_cancel(expiry_heap_t *heap, uint16_t lot);                             // Remove o prazo da vaga
+bool expiry_heap_contains(const expiry_heap_t *heap, uint16_t lot);
+bool expiry_heap_peek(const expiry_heap_t *heap, absolute_time_t *deadline);             // Prazo mais próximo
+bool expiry_heap_pop_expired(expiry_heap_t *heap, absolute_time_t now, uint16_t *lot);   // Retira um prazo vencido
+
+#endif // EXPIRY_HEAP_H
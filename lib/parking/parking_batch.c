@@ -0,0 +1,166 @@
+#include "parking_batch.h"
+#include <string.h>
+
+// Etapas do decodificador
+enum
+{
+    BATCH_STAGE_HEADER,
+    BATCH_STAGE_ITEMS,
+    BATCH_STAGE_DURATION,
+    BATCH_STAGE_BITMAP,
+    BATCH_STAGE_INVALID,
+};
+
+static uint16_t batch_get_u16(const uint8_t *buffer)
+{
+    return (buffer[0] << 8) | buffer[1];
+}
+
+// Guarda um item; além da capacidade só conta, para o lote ser recusado inteiro no fim
+static void batch_add(parking_batch_t *batch, uint16_t lot, uint16_t duration_s)
+{
+    if (batch->count >= batch->capacity)
+    {
+        batch->status = PARKING_BATCH_TOO_MANY;
+        return;
+    }
+    batch->items[batch->count].lot = lot;
+    batch->items[batch->count].duration_s = duration_s;
+    batch->count++;
+}
+
+// Tamanho do próximo campo de tamanho fixo (0 no bitmap, tratado byte a byte)
+static uint8_t batch_field_len(uint8_t stage)
+{
+    switch (stage)
+    {
+    case BATCH_STAGE_HEADER:
+        return PARKING_BATCH_HEADER;
+    case BATCH_STAGE_ITEMS:
+        return 4;
+    case BATCH_STAGE_DURATION:
+        return 2;
+    default:
+        return 0;
+    }
+}
+
+// Interpreta um campo completo e avança a etapa
+static void batch_field(parking_batch_t *batch, const uint8_t *field)
+{
+    switch (batch->stage)
+    {
+    case BATCH_STAGE_HEADER:
+        batch->format = field[0];
+        batch->sequence = batch_get_u16(&field[1]);
+        if (batch->format == PARKING_BATCH_LIST)
+            batch->stage = BATCH_STAGE_ITEMS;
+        else if (batch->format == PARKING_BATCH_BITMAP)
+            batch->stage = BATCH_STAGE_DURATION;
+        else
+            batch->stage = BATCH_STAGE_INVALID;
+        break;
+    case BATCH_STAGE_ITEMS:
+        batch_add(batch, batch_get_u16(field), batch_get_u16(&field[2]));
+        break;
+    case BATCH_STAGE_DURATION:
+        batch->duration_s = batch_get_u16(field);
+        batch->stage = BATCH_STAGE_BITMAP;
+        break;
+    }
+}
+
+void parking_batch_init(parking_batch_t *batch, parking_batch_item_t *items, uint16_t capacity, uint16_t lots)
+{
+    memset(batch, 0, sizeof(*batch));
+    batch->items = items;
+    batch->capacity = capacity;
+    batch->lots = lots;
+}
+
+void parking_batch_begin(parking_batch_t *batch)
+{
+    batch->count = 0;
+    batch->format = 0;
+    batch->sequence = 0;
+    batch->duration_s = 0;
+    batch->next_lot = 1;
+    batch->stage = BATCH_STAGE_HEADER;
+    batch->pending_len = 0;
+    batch->status = PARKING_BATCH_OK;
+}
+
+// Campos inteiros dentro do fragmento são lidos no lugar; só o que atravessa fragmentos é copiado.
+// O bitmap para na última vaga configurada: um bit ou byte além dela torna o lote malformado
+void parking_batch_feed(parking_batch_t *batch, const uint8_t *data, size_t len)
+{
+    while (len > 0 && batch->stage != BATCH_STAGE_INVALID)
+    {
+        if (batch->stage == BATCH_STAGE_BITMAP)
+        {
+            for (; len > 0; data++, len--, batch->next_lot += 8)
+            {
+                if (batch->next_lot > batch->lots)
+                {
+                    batch->stage = BATCH_STAGE_INVALID;
+                    return;
+                }
+                for (uint8_t bits = *data; bits; bits &= bits - 1)
+                {
+                    uint32_t lot = batch->next_lot + __builtin_ctz(bits);
+                    if (lot > batch->lots)
+                    {
+                        batch->stage = BATCH_STAGE_INVALID;
+                        return;
+                    }
+                    batch_add(batch, lot, batch->duration_s);
+                }
+            }
+            return;
+        }
+
+        uint8_t field_len = batch_field_len(batch->stage);
+        if (batch->pending_len == 0 && len >= field_len)
+        {
+            batch_field(batch, data);
+            data += field_len;
+            len -= field_len;
+            continue;
+        }
+
+        size_t take = MIN(len, (size_t)(field_len - batch->pending_len));
+        memcpy(&batch->pending[batch->pending_len], data, take);
+        batch->pending_len += take;
+        data += take;
+        len -= take;
+        if (batch->pending_len == field_len)
+        {
+            batch->pending_len = 0;
+            batch_field(batch, batch->pending);
+        }
+    }
+}
+
+parking_batch_status_t parking_batch_end(parking_batch_t *batch)
+{
+    bool complete = (batch->stage == BATCH_STAGE_ITEMS || batch->stage == BATCH_STAGE_BITMAP) && batch->pending_len == 0;
+    if (!complete)
+        batch->status = PARKING_BATCH_MALFORMED;
+    return batch->status;
+}
+
+size_t parking_batch_reply(const parking_batch_t *batch, const uint8_t *results, uint8_t *buffer, size_t size)
+{
+    uint16_t count = (batch->status == PARKING_BATCH_OK && results) ? batch->count : 0;
+    if (size < (size_t)PARKING_BATCH_REPLY_BYTES(count))
+        return 0;
+
+    buffer[0] = batch->sequence >> 8;
+    buffer[1] = batch->sequence;
+    buffer[2] = batch->status;
+    buffer[3] = count >> 8;
+    buffer[4] = count;
+    if (count)
+        memcpy(&buffer[PARKING_BATCH_REPLY_HEADER], results, count);
+    return PARKING_BATCH_REPLY_BYTES(count);
+}
@@ -0,0 +1,74 @@
+#ifndef PARKING_BATCH_H
+#define PARKING_BATCH_H
+
+#include <stdlib.h>
+#include "pico/stdlib.h"
+
+// Formato do comando em lote (todos os inteiros em big-endian):
+//   byte 0     formato (PARKING_BATCH_LIST ou PARKING_BATCH_BITMAP)
+//   bytes 1-2  número de sequência, devolvido na resposta
+//   LIST:   por item, vaga (2 bytes, a partir de 1) e duração em s (2 bytes; 0 libera a reserva)
+//   BITMAP: duração em s (2 bytes) comum a todas as vagas e bitmap das vagas (bit 0 do primeiro byte = vaga 1),
+//           de até (vagas + 7) / 8 bytes; um bit ou byte além da última vaga torna o lote malformado
+// Resposta: sequência (2), status do lote (1), quantidade de itens (2) e um resultado (1 byte) por item, em ordem
+#define PARKING_BATCH_LIST 1
+#define PARKING_BATCH_BITMAP 2
+
+#define PARKING_BATCH_HEADER 3
+#define PARKING_BATCH_REPLY_HEADER 5
+
+// Maior comando aceito para até "items" itens em "lots" vagas
+#define PARKING_BATCH_MAX_BYTES(lots, items) \
+    (PARKING_BATCH_HEADER + ((items) * 4 > 2 + ((lots) + 7) / 8 ? (items) * 4 : 2 + ((lots) + 7) / 8))
+#define PARKING_BATCH_REPLY_BYTES(items) (PARKING_BATCH_REPLY_HEADER + (items))
+
+// Status do lote; fora de PARKING_BATCH_OK nenhum item é aplicado
+typedef enum
+{
+    PARKING_BATCH_OK,
+    PARKING_BATCH_MALFORMED, // Formato desconhecido ou mensagem truncada
+    PARKING_BATCH_TOO_MANY,  // Mais itens que a capacidade
+} parking_batch_status_t;
+
+// Resultado de cada item
+typedef enum
+{
+    PARKING_BATCH_APPLIED,
+    PARKING_BATCH_INVALID_LOT,  // Vaga fora do intervalo
+    PARKING_BATCH_NOT_FREE,     // Reserva de vaga ocupada
+    PARKING_BATCH_NOT_RESERVED, // Liberação de vaga sem reserva
+    PARKING_BATCH_NO_CAPACITY,  // Tabela de reservas cheia
+} parking_batch_result_t;
+
+typedef struct
+{
+    uint16_t lot;        // Vaga como recebida (a partir de 1)
+    uint16_t duration_s; // 0 libera a reserva
+} parking_batch_item_t;
+
+// Decodificador incremental: aceita o comando em fragmentos de qualquer tamanho
+typedef struct
+{
+    parking_batch_item_t *items;
+    uint16_t capacity;
+    uint16_t lots; // Vagas configuradas: limite do bitmap
+    uint16_t count;
+    uint8_t format;
+    uint16_t sequence;
+    uint16_t duration_s; // Duração comum (BITMAP)
+    uint32_t next_lot;   // Vaga do próximo bit (BITMAP)
+    uint8_t stage;
+    uint8_t pending[4]; // Campo incompleto que atravessa fragmentos
+    uint8_t pending_len;
+    parking_batch_status_t status;
+} parking_batch_t;
+
+void parking_batch_init(parking_batch_t *batch, parking_batch_item_t *items, uint16_t capacity, uint16_t lots);
+void parking_batch_begin(parking_batch_t *batch);
+void parking_batch_feed(parking_batch_t *batch, const uint8_t *data, size_t len);
+parking_batch_status_t parking_batch_end(parking_batch_t *batch); // Status final do lote completo
+
+// Monta a resposta; results pode ser NULL quando o lote não foi aplicado. Retorna o tamanho
+size_t parking_batch_reply(const parking_batch_t *batch, const uint8_t *results, uint8_t *buffer, size_t size);
+
+#endif // PARKING_BATCH_H
@@ -0,0 +1,146 @@
+#include "parking_journal.h"
+
+#if PARKING_JOURNAL_FLASH
+#include "hardware/flash.h"
+#include "hardware/sync.h"
+#endif
+
+// Anel na RAM com as transições mais recentes
+static journal_entry_t ram_entries[PARKING_JOURNAL_SIZE];
+static uint32_t ram_head = 0, ram_count = 0;
+
+static uint32_t peeked = 0; // Entradas entregues pelo último peek e ainda não confirmadas
+static parking_journal_stats_t stats;
+
+#if PARKING_JOURNAL_FLASH
+// Anel de setores no fim da flash com as transições mais antigas (anteriores às da RAM)
+#define JOURNAL_FLASH_BYTES (PARKING_JOURNAL_FLASH_SECTORS * FLASH_SECTOR_SIZE)
+#define JOURNAL_FLASH_OFFSET (PICO_FLASH_SIZE_BYTES - JOURNAL_FLASH_BYTES)
+#define JOURNAL_FLASH_CAPACITY (JOURNAL_FLASH_BYTES / sizeof(journal_entry_t))
+#define JOURNAL_PAGE_ENTRIES (FLASH_PAGE_SIZE / sizeof(journal_entry_t))
+#define JOURNAL_SECTOR_ENTRIES (FLASH_SECTOR_SIZE / sizeof(journal_entry_t))
+
+static const journal_entry_t *flash_entries = (const journal_entry_t *)(XIP_BASE + JOURNAL_FLASH_OFFSET);
+static uint32_t flash_head = 0, flash_count = 0;
+#else
+static const uint32_t flash_count = 0;
+#endif
+
+// Descarta as "count" entradas mais antigas (o que já foi entregue ao consumidor deixa de precisar de commit)
+static void journal_drop(uint32_t count)
+{
+    stats.dropped += count;
+    peeked = peeked > count ? peeked - count : 0;
+}
+
+#if PARKING_JOURNAL_FLASH
+// Move a página mais antiga da RAM para o fim do anel da flash
+static void journal_spill(void)
+{
+    uint32_t tail = (flash_head + flash_count) % JOURNAL_FLASH_CAPACITY; // Sempre alinhado a uma página
+
+    // Entrar num setor exige apagá-lo: as entradas ainda não lidas desse setor são perdidas
+    if (tail % JOURNAL_SECTOR_ENTRIES == 0 && flash_count && flash_head / JOURNAL_SECTOR_ENTRIES == tail / JOURNAL_SECTOR_ENTRIES)
+    {
+        uint32_t lost = JOURNAL_SECTOR_ENTRIES - flash_head % JOURNAL_SECTOR_ENTRIES;
+        flash_head = (flash_head + lost) % JOURNAL_FLASH_CAPACITY;
+        flash_count -= lost;
+        journal_drop(lost);
+    }
+
+    journal_entry_t page[JOURNAL_PAGE_ENTRIES];
+    for (uint32_t i = 0; i < JOURNAL_PAGE_ENTRIES; i++)
+        page[i] = ram_entries[(ram_head + i) % PARKING_JOURNAL_SIZE];
+
+    uint32_t offset = JOURNAL_FLASH_OFFSET + tail * sizeof(journal_entry_t);
+    uint32_t interrupts = save_and_disable_interrupts();
+    if (offset % FLASH_SECTOR_SIZE == 0)
+        flash_range_erase(offset, FLASH_SECTOR_SIZE);
+    flash_range_program(offset, (const uint8_t *)page, FLASH_PAGE_SIZE);
+    restore_interrupts(interrupts);
+
+    // A ordem lógica (flash e depois RAM) não muda, então o último peek continua válido
+    ram_head = (ram_head + JOURNAL_PAGE_ENTRIES) % PARKING_JOURNAL_SIZE;
+    ram_count -= JOURNAL_PAGE_ENTRIES;
+    flash_count += JOURNAL_PAGE_ENTRIES;
+    stats.spilled += JOURNAL_PAGE_ENTRIES;
+}
+#endif
+
+// Entrada na posição lógica i (0 = mais antiga)
+static const journal_entry_t *journal_at(uint32_t i)
+{
+#if PARKING_JOURNAL_FLASH
+    if (i < flash_count)
+        return &flash_entries[(flash_head + i) % JOURNAL_FLASH_CAPACITY];
+#endif
+    return &ram_entries[(ram_head + i - flash_count) % PARKING_JOURNAL_SIZE];
+}
+
+void parking_journal_init(void)
+{
+    ram_head = ram_count = 0;
+    peeked = 0;
+#if PARKING_JOURNAL_FLASH
+    flash_head = flash_count = 0;
+#endif
+}
+
+// Registra uma transição; com a RAM cheia ela transborda para a flash ou a mais antiga é descartada
+void parking_journal_record(uint16_t lot, uint8_t status, uint32_t timestamp_ms)
+{
+    if (ram_count == PARKING_JOURNAL_SIZE)
+    {
+#if PARKING_JOURNAL_FLASH
+        journal_spill();
+#else
+        ram_head = (ram_head + 1) % PARKING_JOURNAL_SIZE;
+        ram_count--;
+        journal_drop(1);
+#endif
+    }
+
+    ram_entries[(ram_head + ram_count) % PARKING_JOURNAL_SIZE] =
+        (journal_entry_t){.timestamp_ms = timestamp_ms, .lot = lot, .status = status};
+    ram_count++;
+    stats.recorded++;
+}
+
+uint32_t parking_journal_count(void)
+{
+    return flash_count + ram_count;
+}
+
+// Copia até "max" transições, das mais antigas para as mais novas; só saem do journal com parking_journal_commit
+uint16_t parking_journal_peek(journal_entry_t *entries, uint16_t max)
+{
+    uint32_t count = parking_journal_count();
+    uint16_t n = count < max ? count : max;
+
+    for (uint16_t i = 0; i < n; i++)
+        entries[i] = *journal_at(i);
+    peeked = n;
+    return n;
+}
+
+// O consumidor confirmou o último peek: remove as entradas entregues
+void parking_journal_commit(void)
+{
+    uint32_t n = peeked;
+    stats.replayed += n;
+    peeked = 0;
+
+#if PARKING_JOURNAL_FLASH
+    uint32_t from_flash = n < flash_count ? n : flash_count;
+    flash_head = (flash_head + from_flash) % JOURNAL_FLASH_CAPACITY;
+    flash_count -= from_flash;
+    n -= from_flash;
+#endif
+    ram_head = (ram_head + n) % PARKING_JOURNAL_SIZE;
+    ram_count -= n;
+}
+
+const parking_journal_stats_t *parking_journal_stats(void)
+{
+    return &stats;
+}
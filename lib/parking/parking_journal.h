@@ -0,0 +1,41 @@
+#ifndef PARKING_JOURNAL_H
+#define PARKING_JOURNAL_H
+
+#include <stdlib.h>
+#include "pico/stdlib.h"
+
+#ifndef PARKING_JOURNAL_SIZE
+#define PARKING_JOURNAL_SIZE 512 // Transições guardadas na RAM (potência de 2)
+#endif
+
+// 1 = quando a RAM enche, as transições mais antigas são movidas para uma região reservada no fim da flash
+#ifndef PARKING_JOURNAL_FLASH
+#define PARKING_JOURNAL_FLASH 0
+#endif
+#define PARKING_JOURNAL_FLASH_SECTORS 8 // 32 KB reservados no fim da flash (4096 transições)
+
+// Transição de uma vaga (8 bytes, 32 por página de flash)
+typedef struct
+{
+    uint32_t timestamp_ms; // Momento da transição (ms desde o boot)
+    uint16_t lot;          // Índice da vaga
+    uint8_t status;        // Novo status
+    uint8_t reserved;
+} journal_entry_t;
+
+typedef struct
+{
+    uint32_t recorded; // Transições registradas
+    uint32_t dropped;  // Transições perdidas por falta de espaço
+    uint32_t spilled;  // Transições movidas para a flash
+    uint32_t replayed; // Transições confirmadas pelo consumidor
+} parking_journal_stats_t;
+
+void parking_journal_init(void);
+void parking_journal_record(uint16_t lot, uint8_t status, uint32_t timestamp_ms);
+uint32_t parking_journal_count(void);
+uint16_t parking_journal_peek(journal_entry_t *entries, uint16_t max); // Mais antigas primeiro, sem remover
+void parking_journal_commit(void);                                      // Remove as entradas do último peek
+const parking_journal_stats_t *parking_journal_stats(void);
+
+#endif // PARKING_JOURNAL_H
@@ -0,0 +1,63 @@
+#include "parking_snapshot.h"
+
+static void snapshot_put_u16(uint8_t *buffer, uint16_t value)
+{
+    buffer[0] = value >> 8;
+    buffer[1] = value;
+}
+
+// Codifica as vagas em sequências; retorna 0 se o resultado não for menor que "limit"
+static size_t snapshot_encode_rle(const parking_store_t *store, uint8_t *buffer, size_t limit)
+{
+    size_t length = 0;
+    uint16_t lot = 0;
+
+    while (lot < store->lots)
+    {
+        uint8_t status = parking_store_get(store, lot);
+        uint16_t run = 1;
+        while (lot + run < store->lots && run < PARKING_SNAPSHOT_MAX_RUN && parking_store_get(store, lot + run) == status)
+            run++;
+
+        if (length + 2 >= limit)
+            return 0;
+        snapshot_put_u16(&buffer[length], (status << 14) | (run - 1));
+        length += 2;
+        lot += run;
+    }
+    return length;
+}
+
+// Copia o bitmap de status byte a byte (independe da ordem de bytes da plataforma)
+static size_t snapshot_encode_packed(const parking_store_t *store, uint8_t *buffer)
+{
+    size_t length = (store->lots + 3) / 4;
+    for (size_t i = 0; i < length; i++)
+        buffer[i] = store->status_bits[i / 4] >> ((i % 4) * 8);
+    return length;
+}
+
+size_t parking_snapshot_encode(const parking_store_t *store, uint32_t sequence, uint8_t *buffer, size_t size)
+{
+    size_t packed = (store->lots + 3) / 4;
+    if (size < PARKING_SNAPSHOT_HEADER + packed)
+        return 0;
+
+    buffer[1] = sequence >> 24;
+    buffer[2] = sequence >> 16;
+    buffer[3] = sequence >> 8;
+    buffer[4] = sequence;
+    snapshot_put_u16(&buffer[5], store->lots);
+
+    size_t length = snapshot_encode_rle(store, &buffer[PARKING_SNAPSHOT_HEADER], packed);
+    if (length)
+    {
+        buffer[0] = PARKING_SNAPSHOT_RLE;
+    }
+    else
+    {
+        buffer[0] = PARKING_SNAPSHOT_PACKED;
+        length = snapshot_encode_packed(store, &buffer[PARKING_SNAPSHOT_HEADER]);
+    }
+    return PARKING_SNAPSHOT_HEADER + length;
+}
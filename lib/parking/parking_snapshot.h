@@ -0,0 +1,24 @@
+#ifndef PARKING_SNAPSHOT_H
+#define PARKING_SNAPSHOT_H
+
+#include "parking_store.h"
+
+// Formato do snapshot (todos os inteiros em big-endian):
+//   byte 0     formato (PARKING_SNAPSHOT_PACKED ou PARKING_SNAPSHOT_RLE)
+//   bytes 1-4  número de sequência
+//   bytes 5-6  quantidade de vagas
+//   PACKED: 2 bits por vaga, 4 vagas por byte, vaga 0 nos bits menos significativos do primeiro byte
+//   RLE:    sequências de uint16 = (status << 14) | (comprimento - 1)
+#define PARKING_SNAPSHOT_PACKED 1
+#define PARKING_SNAPSHOT_RLE 2
+
+#define PARKING_SNAPSHOT_HEADER 7
+#define PARKING_SNAPSHOT_MAX_RUN (1u << 14)
+
+// Tamanho máximo do snapshot de "lots" vagas (o RLE só é usado quando é menor que o empacotado)
+#define PARKING_SNAPSHOT_MAX_BYTES(lots) (PARKING_SNAPSHOT_HEADER + ((lots) + 3) / 4)
+
+// Codifica todas as vagas no formato mais curto; retorna o tamanho ou 0 se não couber no buffer
+size_t parking_snapshot_encode(const parking_store_t *store, uint32_t sequence, uint8_t *buffer, size_t size);
+
+#endif // PARKING_SNAPSHOT_H
@@ -0,0 +1,121 @@
+#include "parking_store.h"
+#include <string.h>
+
+// Bitmap de mudanças de um consumidor
+static inline uint32_t *parking_changed(const parking_store_t *store, parking_tracker_t tracker)
+{
+    return &store->changed_bits[tracker * PARKING_FLAG_WORDS(store->lots)];
+}
+
+// Inicializa todas as vagas como livres e sem mudanças pendentes
+void parking_store_init(parking_store_t *store)
+{
+    memset(store->status_bits, 0, PARKING_STATUS_WORDS(store->lots) * sizeof(uint32_t));
+    memset(store->changed_bits, 0, PARKING_TRACKERS * PARKING_FLAG_WORDS(store->lots) * sizeof(uint32_t));
+    memset(store->first_changed, 0, sizeof(store->first_changed));
+    memset(store->pending, 0, sizeof(store->pending));
+    memset(store->counts, 0, sizeof(store->counts));
+    store->counts[PARKING_FREE] = store->lots;
+    store->version = 0;
+}
+
+uint8_t parking_store_get(const parking_store_t *store, uint16_t lot)
+{
+    if (lot >= store->lots)
+        return PARKING_UNKNOWN;
+
+    uint32_t word = store->status_bits[lot / PARKING_STATUS_PER_WORD];
+    return (word >> ((lot % PARKING_STATUS_PER_WORD) * 2)) & 0b11;
+}
+
+// Altera o status de uma vaga, atualizando as contagens e marcando a mudança para todos os consumidores
+bool parking_store_set(parking_store_t *store, uint16_t lot, uint8_t status)
+{
+    if (lot >= store->lots)
+        return false;
+
+    status &= 0b11;
+    uint32_t *word = &store->status_bits[lot / PARKING_STATUS_PER_WORD];
+    uint8_t shift = (lot % PARKING_STATUS_PER_WORD) * 2;
+    uint8_t old = (*word >> shift) & 0b11;
+    if (old == status)
+        return false;
+
+    *word = (*word & ~(0b11u << shift)) | ((uint32_t)status << shift);
+    store->counts[old]--;
+    store->counts[status]++;
+    store->version++;
+
+    for (int tracker = 0; tracker < PARKING_TRACKERS; tracker++)
+        parking_store_mark_changed(store, tracker, lot);
+    return true;
+}
+
+uint16_t parking_store_count(const parking_store_t *store, uint8_t status)
+{
+    return store->counts[status & 0b11];
+}
+
+void parking_store_mark_changed(parking_store_t *store, parking_tracker_t tracker, uint16_t lot)
+{
+    if (lot >= store->lots)
+        return;
+
+    uint16_t word = lot / PARKING_FLAGS_PER_WORD;
+    uint32_t mask = 1u << (lot % PARKING_FLAGS_PER_WORD);
+    uint32_t *bits = &parking_changed(store, tracker)[word];
+    if (!(*bits & mask))
+        store->pending[tracker]++;
+    *bits |= mask;
+    if (word < store->first_changed[tracker])
+        store->first_changed[tracker] = word;
+}
+
+// Força o consumidor a reprocessar todas as vagas (ex.: ressincronização completa)
+void parking_store_mark_all_changed(parking_store_t *store, parking_tracker_t tracker)
+{
+    uint32_t *bits = parking_changed(store, tracker);
+    uint16_t words = PARKING_FLAG_WORDS(store->lots);
+    memset(bits, 0xFF, words * sizeof(uint32_t));
+
+    uint16_t tail = store->lots % PARKING_FLAGS_PER_WORD;
+    if (tail)
+        bits[words - 1] = (1u << tail) - 1;
+    store->first_changed[tracker] = 0;
+    store->pending[tracker] = store->lots;
+}
+
+// Retira a próxima vaga alterada (menor índice primeiro); palavras sem mudanças são puladas inteiras
+// e a busca recomeça de onde parou, então percorrer todas as mudanças custa O(palavras + mudanças)
+bool parking_store_take_changed(parking_store_t *store, parking_tracker_t tracker, uint16_t *lot)
+{
+    uint32_t *bits = parking_changed(store, tracker);
+    uint16_t words = PARKING_FLAG_WORDS(store->lots);
+
+    for (uint16_t i = store->first_changed[tracker]; i < words; i++)
+    {
+        if (bits[i] == 0)
+            continue;
+
+        store->first_changed[tracker] = i;
+        uint8_t bit = __builtin_ctz(bits[i]);
+        bits[i] &= bits[i] - 1;
+        store->pending[tracker]--;
+        *lot = i * PARKING_FLAGS_PER_WORD + bit;
+        return true;
+    }
+
+    store->first_changed[tracker] = words;
+    return false;
+}
+
+bool parking_store_has_changes(const parking_store_t *store, parking_tracker_t tracker)
+{
+    return store->pending[tracker] != 0;
+}
+
+// Quantidade de vagas com mudança pendente para o consumidor (O(1))
+uint16_t parking_store_pending(const parking_store_t *store, parking_tracker_t tracker)
+{
+    return store->pending[tracker];
+}
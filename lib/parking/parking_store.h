@@ -0,0 +1,62 @@
+#ifndef PARKING_STORE_H
+#define PARKING_STORE_H
+
+#include <stdlib.h>
+#include "pico/stdlib.h"
+
+// Status de uma vaga (2 bits)
+typedef enum
+{
+    PARKING_FREE = 0,     // Livre
+    PARKING_OCCUPIED = 1, // Ocupada
+    PARKING_RESERVED = 2, // Reservada
+    PARKING_UNKNOWN = 3,  // Indefinida
+} parking_status_t;
+
+// Consumidores das mudanças de status; cada um tem seu próprio bitmap e o consome de forma independente
+typedef enum
+{
+    PARKING_TRACK_OUTPUTS = 0, // LEDs, matriz, display e buzzer
+    PARKING_TRACK_PUBLISH,     // Vagas ainda não confirmadas pelo broker MQTT
+    PARKING_TRACKERS
+} parking_tracker_t;
+
+#define PARKING_STATUS_PER_WORD 16 // 2 bits por vaga em palavras de 32 bits
+#define PARKING_FLAGS_PER_WORD 32  // 1 bit por vaga
+
+#define PARKING_STATUS_WORDS(lots) (((lots) + PARKING_STATUS_PER_WORD - 1) / PARKING_STATUS_PER_WORD)
+#define PARKING_FLAG_WORDS(lots) (((lots) + PARKING_FLAGS_PER_WORD - 1) / PARKING_FLAGS_PER_WORD)
+
+// Estado compacto das vagas: bitmap de status, bitmaps de mudança e contagem por status mantida em O(1)
+typedef struct
+{
+    uint32_t *status_bits;                    // 2 bits por vaga
+    uint32_t *changed_bits;                   // PARKING_TRACKERS bitmaps consecutivos, 1 bit por vaga
+    uint16_t lots;                            // Quantidade de vagas
+    uint16_t counts[4];                       // Vagas em cada status
+    uint16_t first_changed[PARKING_TRACKERS]; // Nenhuma palavra antes desta tem mudanças pendentes
+    uint16_t pending[PARKING_TRACKERS];       // Vagas marcadas em cada bitmap de mudanças
+    uint32_t version;                         // Incrementada a cada mudança de status
+} parking_store_t;
+
+// Declara um estado com armazenamento estático para "lots" vagas
+#define PARKING_STORE_DEFINE(name, lots_)                                          \
+    static uint32_t name##_status[PARKING_STATUS_WORDS(lots_)];                    \
+    static uint32_t name##_changed[PARKING_TRACKERS * PARKING_FLAG_WORDS(lots_)];  \
+    static parking_store_t name = {.status_bits = name##_status, .changed_bits = name##_changed, .lots = (lots_)}
+
+// Bytes ocupados por um estado de "lots" vagas (bitmaps + estrutura)
+#define PARKING_STORE_BYTES(lots) \
+    (sizeof(uint32_t) * (PARKING_STATUS_WORDS(lots) + PARKING_TRACKERS * PARKING_FLAG_WORDS(lots)) + sizeof(parking_store_t))
+
+void parking_store_init(parking_store_t *store);
+uint8_t parking_store_get(const parking_store_t *store, uint16_t lot);
+bool parking_store_set(parking_store_t *store, uint16_t lot, uint8_t status); // true se o status mudou
+uint16_t parking_store_count(const parking_store_t *store, uint8_t status);
+void parking_store_mark_changed(parking_store_t *store, parking_tracker_t tracker, uint16_t lot);
+void parking_store_mark_all_changed(parking_store_t *store, parking_tracker_t tracker);
+bool parking_store_take_changed(parking_store_t *store, parking_tracker_t tracker, uint16_t *lot); // Próxima vaga alterada
+bool parking_store_has_changes(const parking_store_t *store, parking_tracker_t tracker);
+uint16_t parking_store_pending(const parking_store_t *store, parking_tracker_t tracker);
+
+#endif // PARKING_STORE_H
@@ -0,0 +1,96 @@
+#include "parking_store_bench.h"
+#include "parking_store.h"
+#include <stdio.h>
+
+#define BENCH_SET_ITERATIONS 20000
+#define BENCH_SCAN_ROUNDS 200
+
+PARKING_STORE_DEFINE(bench_small, 4);
+PARKING_STORE_DEFINE(bench_medium, 256);
+PARKING_STORE_DEFINE(bench_large, 4096);
+
+// Gerador pseudoaleatório simples (xorshift) para não depender de rand()
+static uint32_t bench_seed = 0x12345678;
+static inline uint32_t bench_random(void)
+{
+    bench_seed ^= bench_seed << 13;
+    bench_seed ^= bench_seed >> 17;
+    bench_seed ^= bench_seed << 5;
+    return bench_seed;
+}
+
+static void bench_report(const char *op, uint16_t lots, uint32_t iterations, uint64_t elapsed_us)
+{
+    printf("bench,%s,%u,%lu,%lu\n", op, lots, (unsigned long)iterations,
+           (unsigned long)(elapsed_us * 1000 / iterations));
+}
+
+// Esvazia o bitmap de mudanças e devolve quantas vagas foram retiradas
+static uint32_t bench_drain(parking_store_t *store)
+{
+    uint32_t taken = 0;
+    uint16_t lot;
+    while (parking_store_take_changed(store, PARKING_TRACK_OUTPUTS, &lot))
+        taken++;
+    return taken;
+}
+
+static void bench_store(parking_store_t *store)
+{
+    uint16_t lots = store->lots;
+    volatile uint32_t sink = 0;
+    uint64_t start;
+
+    parking_store_init(store);
+
+    // Atualização: status aleatório em vaga aleatória (inclui manter contagem e marcar mudança)
+    start = time_us_64();
+    for (uint32_t i = 0; i < BENCH_SET_ITERATIONS; i++)
+        parking_store_set(store, bench_random() % lots, bench_random() % 3);
+    bench_report("set", lots, BENCH_SET_ITERATIONS, time_us_64() - start);
+
+    // Contagem de vagas livres (antes era uma varredura completa)
+    start = time_us_64();
+    for (uint32_t i = 0; i < BENCH_SET_ITERATIONS; i++)
+        sink += parking_store_count(store, PARKING_FREE);
+    bench_report("count_free", lots, BENCH_SET_ITERATIONS, time_us_64() - start);
+
+    // Varredura com uma única mudança pendente: custo de encontrar a mudança entre todas as vagas
+    bench_drain(store);
+    start = time_us_64();
+    for (uint32_t i = 0; i < BENCH_SCAN_ROUNDS; i++)
+    {
+        parking_store_mark_changed(store, PARKING_TRACK_OUTPUTS, bench_random() % lots);
+        sink += bench_drain(store);
+    }
+    bench_report("scan_one_change", lots, BENCH_SCAN_ROUNDS, time_us_64() - start);
+
+    // Varredura com todas as vagas alteradas (ressincronização completa)
+    start = time_us_64();
+    for (uint32_t i = 0; i < BENCH_SCAN_ROUNDS; i++)
+    {
+        parking_store_mark_all_changed(store, PARKING_TRACK_OUTPUTS);
+        sink += bench_drain(store);
+    }
+    bench_report("scan_all_changed", lots, BENCH_SCAN_ROUNDS, time_us_64() - start);
+
+    // Leitura de todas as vagas, como na publicação completa
+    start = time_us_64();
+    for (uint32_t i = 0; i < BENCH_SCAN_ROUNDS; i++)
+    {
+        for (uint16_t lot = 0; lot < lots; lot++)
+            sink += parking_store_get(store, lot);
+    }
+    bench_report("read_all", lots, BENCH_SCAN_ROUNDS, time_us_64() - start);
+
+    printf("footprint,%u,%u\n", lots, (unsigned)PARKING_STORE_BYTES(lots));
+    (void)sink;
+}
+
+void parking_store_bench(void)
+{
+    printf("bench,op,lots,iterations,ns_per_op\n");
+    bench_store(&bench_small);
+    bench_store(&bench_medium);
+    bench_store(&bench_large);
+}
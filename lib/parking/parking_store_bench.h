@@ -0,0 +1,9 @@
+#ifndef PARKING_STORE_BENCH_H
+#define PARKING_STORE_BENCH_H
+
+// Mede o custo de atualização e varredura do estado das vagas para 4, 256 e 4096 vagas.
+// Imprime uma linha CSV por medida: bench,<operação>,<vagas>,<iterações>,<ns por operação>
+// e o tamanho do estado de cada configuração: footprint,<vagas>,<bytes>
+void parking_store_bench(void);
+
+#endif // PARKING_STORE_BENCH_H
@@ -1,5 +1,12 @@
 #include "ssd1306.h"
 #include "font.h"
+#include <string.h>
+
+#if SSD1306_USE_DMA
+#include "hardware/dma.h"
+#include "hardware/irq.h"
+#include "hardware/sync.h"
+#endif
 
 void ssd1306_init(ssd1306_t *ssd, uint8_t width, uint8_t height, bool external_vcc, uint8_t address, i2c_inst_t *i2c) {
   ssd->width = width;
@@ -11,6 +18,50 @@ void ssd1306_init(ssd1306_t *ssd, uint8_t width, uint8_t height, bool external_v
   ssd->ram_buffer = calloc(ssd->bufsize, sizeof(uint8_t));
   ssd->ram_buffer[0] = 0x40;
   ssd->port_buffer[0] = 0x80;
+  ssd->tx_buffer = malloc(SSD1306_WINDOW_HEADER + ssd->pages * ssd->width);
+  ssd->sent_buffer = malloc(ssd->bufsize - 1);
+  ssd->dma_buffer = NULL;
+  ssd->dma_chan = -1;
+  ssd->busy = false;
+  ssd->flush_pending = false;
+  ssd->aborted = false;
+  ssd->done_cb = NULL;
+  ssd->done_arg = NULL;
+  ssd1306_invalidate(ssd);
+}
+
+// Marca a tela inteira como alterada; o próximo envio será completo.
+void ssd1306_invalidate(ssd1306_t *ssd) {
+  ssd->sent_valid = false;
+  for (uint8_t page = 0; page < SSD1306_MAX_PAGES; ++page) {
+    ssd->dirty_x0[page] = 0;
+    ssd->dirty_x1[page] = ssd->width - 1;
+  }
+}
+
+static inline void ssd1306_mark_dirty(ssd1306_t *ssd, uint8_t page, uint8_t x) {
+  if (x < ssd->dirty_x0[page])
+    ssd->dirty_x0[page] = x;
+  if (x > ssd->dirty_x1[page])
+    ssd->dirty_x1[page] = x;
+}
+
+static inline void ssd1306_mark_range(ssd1306_t *ssd, uint8_t page, uint8_t x0, uint8_t x1) {
+  if (x0 < ssd->dirty_x0[page])
+    ssd->dirty_x0[page] = x0;
+  if (x1 > ssd->dirty_x1[page])
+    ssd->dirty_x1[page] = x1;
+}
+
+static inline bool ssd1306_page_is_dirty(const ssd1306_t *ssd, uint8_t page) {
+  return ssd->dirty_x0[page] <= ssd->dirty_x1[page];
+}
+
+static inline void ssd1306_clear_dirty(ssd1306_t *ssd) {
+  for (uint8_t page = 0; page < SSD1306_MAX_PAGES; ++page) {
+    ssd->dirty_x0[page] = 0xFF;
+    ssd->dirty_x1[page] = 0;
+  }
 }
 
 void ssd1306_config(ssd1306_t *ssd) {
@@ -42,6 +93,7 @@ void ssd1306_config(ssd1306_t *ssd) {
 }
 
 void ssd1306_command(ssd1306_t *ssd, uint8_t command) {
+  ssd1306_wait(ssd);
   ssd->port_buffer[1] = command;
   i2c_write_blocking(
     ssd->i2c_port,
@@ -52,66 +104,371 @@ void ssd1306_command(ssd1306_t *ssd, uint8_t command) {
   );
 }
 
+typedef struct {
+  uint8_t p0, p1, x0, x1;
+} ssd1306_window_t;
+
+// Monta uma janela (páginas p0..p1, colunas x0..x1) como uma única transação I2C em tx.
+// Os comandos vão com Co = 1 (0x80) e o byte 0x40 inicia os dados, no modo de endereçamento vertical.
+static size_t ssd1306_build_window(const ssd1306_t *ssd, const ssd1306_window_t *w, uint8_t *tx) {
+  const uint8_t header[SSD1306_WINDOW_HEADER] = {
+    0x80, SET_COL_ADDR, 0x80, w->x0, 0x80, w->x1,
+    0x80, SET_PAGE_ADDR, 0x80, w->p0, 0x80, w->p1,
+    0x40
+  };
+  memcpy(tx, header, sizeof(header));
+  size_t len = sizeof(header);
+
+  uint8_t pages = w->p1 - w->p0 + 1;
+  for (uint16_t x = w->x0; x <= w->x1; ++x) {
+    memcpy(&tx[len], &ssd->ram_buffer[(x << 3) + w->p0 + 1], pages);
+    len += pages;
+  }
+  return len;
+}
+
+// Agrupa as páginas alteradas em janelas.
+// Páginas vizinhas são agrupadas numa mesma janela quando isso custa menos bytes que enviá-las separadas;
+// acima de SSD1306_FULL_FLUSH_PERCENT da tela alterada, envia a tela inteira.
+static uint8_t ssd1306_select_windows(ssd1306_t *ssd, ssd1306_window_t windows[SSD1306_MAX_PAGES]) {
+  uint16_t dirty_bytes = 0;
+  for (uint8_t page = 0; page < ssd->pages; ++page) {
+    if (ssd1306_page_is_dirty(ssd, page))
+      dirty_bytes += ssd->dirty_x1[page] - ssd->dirty_x0[page] + 1;
+  }
+
+  if (dirty_bytes == 0)
+    return 0;
+
+  uint8_t count = 0;
+  if (dirty_bytes * 100U >= (uint32_t)ssd->pages * ssd->width * SSD1306_FULL_FLUSH_PERCENT) {
+    windows[count++] = (ssd1306_window_t){0, ssd->pages - 1, 0, ssd->width - 1};
+    return count;
+  }
+
+  ssd1306_window_t *w = NULL;
+  for (uint8_t page = 0; page < ssd->pages; ++page) {
+    if (!ssd1306_page_is_dirty(ssd, page))
+      continue;
+
+    uint8_t px0 = ssd->dirty_x0[page], px1 = ssd->dirty_x1[page];
+    if (w && page == w->p1 + 1) {
+      uint8_t mx0 = px0 < w->x0 ? px0 : w->x0;
+      uint8_t mx1 = px1 > w->x1 ? px1 : w->x1;
+      uint32_t merged = (uint32_t)(mx1 - mx0 + 1) * (page - w->p0 + 1);
+      uint32_t split = (uint32_t)(w->x1 - w->x0 + 1) * (w->p1 - w->p0 + 1) + (px1 - px0 + 1) + SSD1306_WINDOW_HEADER + 1;
+      if (merged <= split) {
+        w->p1 = page;
+        w->x0 = mx0;
+        w->x1 = mx1;
+        continue;
+      }
+    }
+
+    w = &windows[count++];
+    *w = (ssd1306_window_t){page, page, px0, px1};
+  }
+
+  return count;
+}
+
+// Reduz a faixa alterada de cada página ao trecho que realmente difere do que o display já tem.
+// Assim, limpar e redesenhar o mesmo conteúdo (ou preencher áreas inteiras) não gera tráfego.
+static void ssd1306_trim_dirty(ssd1306_t *ssd) {
+  if (!ssd->sent_valid)
+    return;
+
+  for (uint8_t page = 0; page < ssd->pages; ++page) {
+    if (!ssd1306_page_is_dirty(ssd, page))
+      continue;
+
+    uint8_t x0 = ssd->dirty_x0[page], x1 = ssd->dirty_x1[page];
+    while (x0 <= x1 && ssd->ram_buffer[(x0 << 3) + page + 1] == ssd->sent_buffer[(x0 << 3) + page])
+      ++x0;
+    while (x1 > x0 && ssd->ram_buffer[(x1 << 3) + page + 1] == ssd->sent_buffer[(x1 << 3) + page])
+      --x1;
+
+    if (x0 > x1) {
+      ssd->dirty_x0[page] = 0xFF;
+      ssd->dirty_x1[page] = 0;
+    } else {
+      ssd->dirty_x0[page] = x0;
+      ssd->dirty_x1[page] = x1;
+    }
+  }
+}
+
+// Seleciona as janelas a enviar, atualiza a cópia do conteúdo do display e limpa as marcações.
+// A cópia é atualizada antes da transferência; se ela for abortada, o envio seguinte é completo.
+static uint8_t ssd1306_collect_windows(ssd1306_t *ssd, ssd1306_window_t windows[SSD1306_MAX_PAGES]) {
+  if (ssd->aborted) {
+    ssd->aborted = false;
+    ssd1306_invalidate(ssd);
+  }
+  ssd1306_trim_dirty(ssd);
+  uint8_t count = ssd1306_select_windows(ssd, windows);
+
+  for (uint8_t i = 0; i < count; ++i) {
+    uint8_t pages = windows[i].p1 - windows[i].p0 + 1;
+    for (uint16_t x = windows[i].x0; x <= windows[i].x1; ++x)
+      memcpy(&ssd->sent_buffer[(x << 3) + windows[i].p0], &ssd->ram_buffer[(x << 3) + windows[i].p0 + 1], pages);
+  }
+  if (count > 0 && windows[0].p0 == 0 && windows[0].p1 == ssd->pages - 1 && windows[0].x0 == 0 && windows[0].x1 == ssd->width - 1)
+    ssd->sent_valid = true;
+
+  ssd1306_clear_dirty(ssd);
+  return count;
+}
+
+// Retorna false (e marca a tela para reenvio completo) se o display não confirmar alguma janela.
+static bool ssd1306_send_windows(ssd1306_t *ssd, const ssd1306_window_t *windows, uint8_t count) {
+  for (uint8_t i = 0; i < count; ++i) {
+    size_t len = ssd1306_build_window(ssd, &windows[i], ssd->tx_buffer);
+    if (i2c_write_blocking(ssd->i2c_port, ssd->address, ssd->tx_buffer, len, false) < 0) {
+      ssd->aborted = true;
+      return false;
+    }
+  }
+  return true;
+}
+
+// Envia a tela inteira.
+void ssd1306_send_full(ssd1306_t *ssd) {
+  ssd1306_wait(ssd);
+  ssd1306_invalidate(ssd);
+  ssd1306_send_data(ssd);
+}
+
+// Envio bloqueante das janelas alteradas; false se o display não respondeu.
+static bool ssd1306_send_data_checked(ssd1306_t *ssd) {
+  ssd1306_wait(ssd);
+  ssd1306_window_t windows[SSD1306_MAX_PAGES];
+  uint8_t count = ssd1306_collect_windows(ssd, windows);
+  return ssd1306_send_windows(ssd, windows, count);
+}
+
+// Envia apenas as janelas alteradas desde o último envio.
 void ssd1306_send_data(ssd1306_t *ssd) {
-  ssd1306_command(ssd, SET_COL_ADDR);
-  ssd1306_command(ssd, 0);
-  ssd1306_command(ssd, ssd->width - 1);
-  ssd1306_command(ssd, SET_PAGE_ADDR);
-  ssd1306_command(ssd, 0);
-  ssd1306_command(ssd, ssd->pages - 1);
-  i2c_write_blocking(
-    ssd->i2c_port,
-    ssd->address,
-    ssd->ram_buffer,
-    ssd->bufsize,
-    false
-  );
+  ssd1306_send_data_checked(ssd);
+}
+
+// Registra a função chamada (em contexto de interrupção, no modo DMA) ao fim de cada envio assíncrono.
+void ssd1306_set_done_callback(ssd1306_t *ssd, ssd1306_done_cb_t cb, void *arg) {
+  ssd->done_cb = cb;
+  ssd->done_arg = arg;
+}
+
+// Indica se um envio assíncrono está em andamento.
+bool ssd1306_is_busy(const ssd1306_t *ssd) {
+  return ssd->busy;
+}
+
+// Indica se houve pedidos de envio durante a transferência atual (serão atendidos por um único envio).
+bool ssd1306_flush_pending(const ssd1306_t *ssd) {
+  return ssd->flush_pending;
+}
+
+#if SSD1306_USE_DMA
+static ssd1306_t *ssd1306_dma_owner = NULL; // Display com a transferência DMA em andamento
+
+// Encerra a transferência uma única vez, mesmo que outra interrupção chegue depois do abort.
+static void ssd1306_dma_finish(ssd1306_t *ssd, bool ok) {
+  i2c_get_hw(ssd->i2c_port)->intr_mask = 0;
+  if (!ssd->busy)
+    return;
+
+  if (!ok)
+    ssd->aborted = true;
+  ssd->busy = false;
+  if (ssd->done_cb)
+    ssd->done_cb(ssd->done_arg, ok);
+}
+
+// Fim do DMA: os últimos bytes ainda estão na FIFO, a conclusão vem com o STOP no barramento.
+static void ssd1306_dma_irq_handler() {
+  ssd1306_t *ssd = ssd1306_dma_owner;
+  if (!ssd || ssd->dma_chan < 0 || !dma_channel_get_irq0_status(ssd->dma_chan))
+    return;
+
+  dma_channel_acknowledge_irq0(ssd->dma_chan);
+  if (!ssd->busy)
+    return;
+  i2c_get_hw(ssd->i2c_port)->intr_mask = I2C_IC_INTR_MASK_M_STOP_DET_BITS | I2C_IC_INTR_MASK_M_TX_ABRT_BITS;
+}
+
+// STOP detectado (transação concluída) ou abort (display não respondeu).
+static void ssd1306_i2c_irq_handler() {
+  ssd1306_t *ssd = ssd1306_dma_owner;
+  if (!ssd)
+    return;
+
+  i2c_hw_t *hw = i2c_get_hw(ssd->i2c_port);
+  bool ok = !(hw->intr_stat & I2C_IC_INTR_STAT_R_TX_ABRT_BITS);
+  if (!ok) {
+    // O abort pode disparar a interrupção do canal (RP2040-E13): desliga-a durante o abort
+    dma_channel_set_irq0_enabled(ssd->dma_chan, false);
+    dma_channel_abort(ssd->dma_chan);
+    dma_channel_acknowledge_irq0(ssd->dma_chan);
+    dma_channel_set_irq0_enabled(ssd->dma_chan, true);
+    (void)hw->clr_tx_abrt;
+  }
+  (void)hw->clr_stop_det;
+  ssd1306_dma_finish(ssd, ok);
+}
+
+// Reserva o canal DMA e registra as interrupções do envio assíncrono.
+static void ssd1306_init_dma(ssd1306_t *ssd) {
+  ssd->dma_buffer = malloc(((size_t)SSD1306_WINDOW_HEADER + ssd->width) * ssd->pages * sizeof(uint16_t));
+  ssd->dma_chan = dma_claim_unused_channel(true);
+  ssd1306_dma_owner = ssd;
+
+  dma_channel_config c = dma_channel_get_default_config(ssd->dma_chan);
+  channel_config_set_transfer_data_size(&c, DMA_SIZE_16);
+  channel_config_set_read_increment(&c, true);
+  channel_config_set_write_increment(&c, false);
+  channel_config_set_dreq(&c, i2c_get_dreq(ssd->i2c_port, true));
+  dma_channel_configure(ssd->dma_chan, &c, &i2c_get_hw(ssd->i2c_port)->data_cmd, ssd->dma_buffer, 0, false);
+  dma_channel_set_irq0_enabled(ssd->dma_chan, true);
+  irq_add_shared_handler(DMA_IRQ_0, ssd1306_dma_irq_handler, PICO_SHARED_IRQ_HANDLER_DEFAULT_ORDER_PRIORITY);
+  irq_set_enabled(DMA_IRQ_0, true);
+
+  uint i2c_irq = i2c_hw_index(ssd->i2c_port) ? I2C1_IRQ : I2C0_IRQ;
+  irq_set_exclusive_handler(i2c_irq, ssd1306_i2c_irq_handler);
+  irq_set_enabled(i2c_irq, true);
+}
+
+// Envia as janelas alteradas sem bloquear: todas vão numa só rajada DMA para a FIFO TX do I2C,
+// separadas por RESTART, e o STOP sai com o último byte. Se já houver uma transferência em andamento,
+// o pedido é apenas registrado e retorna false; as alterações continuam marcadas para o próximo envio.
+bool ssd1306_send_data_async(ssd1306_t *ssd) {
+  uint32_t irq_state = save_and_disable_interrupts();
+  if (ssd->busy) {
+    ssd->flush_pending = true;
+    restore_interrupts(irq_state);
+    return false;
+  }
+  ssd->flush_pending = false;
+  restore_interrupts(irq_state);
+
+  if (ssd->dma_chan < 0)
+    ssd1306_init_dma(ssd);
+
+  ssd1306_window_t windows[SSD1306_MAX_PAGES];
+  uint8_t count = ssd1306_collect_windows(ssd, windows);
+  if (count == 0)
+    return true;
+
+  uint32_t words = 0;
+  for (uint8_t i = 0; i < count; ++i) {
+    size_t len = ssd1306_build_window(ssd, &windows[i], ssd->tx_buffer);
+    for (size_t j = 0; j < len; ++j)
+      ssd->dma_buffer[words + j] = ssd->tx_buffer[j];
+    if (i > 0)
+      ssd->dma_buffer[words] |= I2C_IC_DATA_CMD_RESTART_BITS;
+    words += len;
+  }
+  ssd->dma_buffer[words - 1] |= I2C_IC_DATA_CMD_STOP_BITS;
+
+  i2c_hw_t *hw = i2c_get_hw(ssd->i2c_port);
+  ssd->busy = true;
+  hw->enable = 0;
+  hw->tar = ssd->address;
+  hw->enable = 1;
+  (void)hw->clr_stop_det;
+  (void)hw->clr_tx_abrt;
+  hw->intr_mask = I2C_IC_INTR_MASK_M_TX_ABRT_BITS;
+
+  dma_channel_transfer_from_buffer_now(ssd->dma_chan, ssd->dma_buffer, words);
+  return true;
+}
+#else
+// Sem DMA o envio é feito de forma bloqueante, mantendo a mesma interface.
+bool ssd1306_send_data_async(ssd1306_t *ssd) {
+  bool ok = ssd1306_send_data_checked(ssd);
+  if (ssd->done_cb)
+    ssd->done_cb(ssd->done_arg, ok);
+  return true;
+}
+#endif
+
+// Aguarda o fim de um envio assíncrono em andamento.
+void ssd1306_wait(ssd1306_t *ssd) {
+  while (ssd->busy)
+    tight_loop_contents();
 }
 
 void ssd1306_pixel(ssd1306_t *ssd, uint8_t x, uint8_t y, bool value) {
+  if (x >= ssd->width || y >= ssd->height)
+    return;
+
   uint16_t index = (y >> 3) + (x << 3) + 1;
   uint8_t pixel = (y & 0b111);
+  uint8_t byte = ssd->ram_buffer[index];
   if (value)
-    ssd->ram_buffer[index] |= (1 << pixel);
+    byte |= (1 << pixel);
   else
-    ssd->ram_buffer[index] &= ~(1 << pixel);
+    byte &= ~(1 << pixel);
+
+  if (byte != ssd->ram_buffer[index]) {
+    ssd->ram_buffer[index] = byte;
+    ssd1306_mark_dirty(ssd, y >> 3, x);
+  }
 }
 
-/*
-void ssd1306_fill(ssd1306_t *ssd, bool value) {
-  uint8_t byte = value ? 0xFF : 0x00;
-  for (uint8_t i = 1; i < ssd->bufsize; ++i)
-    ssd->ram_buffer[i] = byte;
-}*/
+// Preenche o retângulo [x0, x1] x [y0, y1] (inclusivo) operando por byte: cada página recebe uma máscara
+// com as linhas cobertas, aplicada coluna a coluna. Páginas inteiras viram atribuição direta.
+static void ssd1306_fill_area(ssd1306_t *ssd, int x0, int y0, int x1, int y1, bool value) {
+  if (x0 < 0) x0 = 0;
+  if (y0 < 0) y0 = 0;
+  if (x1 >= ssd->width) x1 = ssd->width - 1;
+  if (y1 >= ssd->height) y1 = ssd->height - 1;
+  if (x0 > x1 || y0 > y1)
+    return;
 
-void ssd1306_fill(ssd1306_t *ssd, bool value) {
-    // Itera por todas as posições do display
-    for (uint8_t y = 0; y < ssd->height; ++y) {
-        for (uint8_t x = 0; x < ssd->width; ++x) {
-            ssd1306_pixel(ssd, x, y, value);
-        }
+  for (int page = y0 >> 3; page <= (y1 >> 3); ++page) {
+    int top = page << 3;
+    uint8_t first = (y0 > top) ? y0 - top : 0;
+    uint8_t last = (y1 < top + 7) ? y1 - top : 7;
+    uint8_t mask = (uint8_t)((0xFFu >> (7 - last)) & (0xFFu << first));
+    uint8_t *byte = &ssd->ram_buffer[(x0 << 3) + page + 1];
+
+    if (mask == 0xFF) {
+      uint8_t fill = value ? 0xFF : 0x00;
+      for (int x = x0; x <= x1; ++x, byte += 8)
+        *byte = fill;
+    } else if (value) {
+      for (int x = x0; x <= x1; ++x, byte += 8)
+        *byte |= mask;
+    } else {
+      for (int x = x0; x <= x1; ++x, byte += 8)
+        *byte &= ~mask;
     }
+    ssd1306_mark_range(ssd, page, x0, x1);
+  }
 }
 
-
+void ssd1306_fill(ssd1306_t *ssd, bool value) {
+  // Preenche o buffer inteiro de uma vez; o envio só transmite o que difere do display
+  memset(&ssd->ram_buffer[1], value ? 0xFF : 0x00, ssd->bufsize - 1);
+  for (uint8_t page = 0; page < ssd->pages; ++page)
+    ssd1306_mark_range(ssd, page, 0, ssd->width - 1);
+}
 
 void ssd1306_rect(ssd1306_t *ssd, uint8_t top, uint8_t left, uint8_t width, uint8_t height, bool value, bool fill) {
-  for (uint8_t x = left; x < left + width; ++x) {
-    ssd1306_pixel(ssd, x, top, value);
-    ssd1306_pixel(ssd, x, top + height - 1, value);
-  }
-  for (uint8_t y = top; y < top + height; ++y) {
-    ssd1306_pixel(ssd, left, y, value);
-    ssd1306_pixel(ssd, left + width - 1, y, value);
-  }
+  if (width == 0 || height == 0)
+    return;
 
+  int right = left + width - 1;
+  int bottom = top + height - 1;
   if (fill) {
-    for (uint8_t x = left + 1; x < left + width - 1; ++x) {
-      for (uint8_t y = top + 1; y < top + height - 1; ++y) {
-        ssd1306_pixel(ssd, x, y, value);
-      }
-    }
+    ssd1306_fill_area(ssd, left, top, right, bottom, value);
+    return;
   }
+
+  ssd1306_fill_area(ssd, left, top, right, top, value);
+  ssd1306_fill_area(ssd, left, bottom, right, bottom, value);
+  ssd1306_fill_area(ssd, left, top, left, bottom, value);
+  ssd1306_fill_area(ssd, right, top, right, bottom, value);
 }
 
 void ssd1306_line(ssd1306_t *ssd, uint8_t x0, uint8_t y0, uint8_t x1, uint8_t y1, bool value) {
@@ -144,16 +501,16 @@ void ssd1306_line(ssd1306_t *ssd, uint8_t x0, uint8_t y0, uint8_t x1, uint8_t y1
 
 
 void ssd1306_hline(ssd1306_t *ssd, uint8_t x0, uint8_t x1, uint8_t y, bool value) {
-  for (uint8_t x = x0; x <= x1; ++x)
-    ssd1306_pixel(ssd, x, y, value);
+  ssd1306_fill_area(ssd, x0, y, x1, y, value);
 }
 
 void ssd1306_vline(ssd1306_t *ssd, uint8_t x, uint8_t y0, uint8_t y1, bool value) {
-  for (uint8_t y = y0; y <= y1; ++y)
-    ssd1306_pixel(ssd, x, y, value);
+  ssd1306_fill_area(ssd, x, y0, x, y1, value);
 }
 
 // Função para desenhar um caractere
+// As colunas da fonte já estão no formato vertical do ram_buffer (bit 0 = linha de cima): com y múltiplo
+// de 8 cada coluna é copiada direto; caso contrário é deslocada e mesclada nas duas páginas que ocupa.
 void ssd1306_draw_char(ssd1306_t *ssd, char c, uint8_t x, uint8_t y)
 {
   uint16_t index = 0;
@@ -169,15 +526,34 @@ void ssd1306_draw_char(ssd1306_t *ssd, char c, uint8_t x, uint8_t y)
     index = 0; // Índice 0 corresponde ao caractere "nada" (espaço)
   }
 
-  // Desenha o caractere na tela
-  for (uint8_t i = 0; i < 8; ++i)
+  if (x >= ssd->width || y >= ssd->height)
+    return;
+
+  const uint8_t *glyph = &font[index];
+  uint8_t page = y >> 3;
+  uint8_t shift = y & 0b111;
+  uint8_t columns = (ssd->width - x < 8) ? ssd->width - x : 8;
+  uint8_t *column = &ssd->ram_buffer[(x << 3) + page + 1];
+
+  if (shift == 0)
+  {
+    for (uint8_t i = 0; i < columns; ++i, column += 8)
+      *column = glyph[i];
+  }
+  else
   {
-    uint8_t line = font[index + i]; // Acessa a linha correspondente do caractere na fonte
-    for (uint8_t j = 0; j < 8; ++j)
+    uint8_t keep = (1 << shift) - 1; // Linhas acima do caractere na primeira página
+    bool second_page = page + 1 < ssd->pages;
+    for (uint8_t i = 0; i < columns; ++i, column += 8)
     {
-      ssd1306_pixel(ssd, x + i, y + j, line & (1 << j)); // Desenha cada pixel do caractere
+      column[0] = (column[0] & keep) | (uint8_t)(glyph[i] << shift);
+      if (second_page)
+        column[1] = (column[1] & ~keep) | (glyph[i] >> (8 - shift));
     }
+    if (second_page)
+      ssd1306_mark_range(ssd, page + 1, x, x + columns - 1);
   }
+  ssd1306_mark_range(ssd, page, x, x + columns - 1);
 }
 
 // Função para desenhar uma string
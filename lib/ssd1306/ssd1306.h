@@ -8,6 +8,18 @@
 #define WIDTH 128
 #define HEIGHT 64
 
+#define SSD1306_MAX_PAGES 8            // ram_buffer usa 8 bytes (páginas) por coluna
+#define SSD1306_WINDOW_HEADER 13       // 6 pares (0x80, comando) + byte de controle 0x40
+#define SSD1306_FULL_FLUSH_PERCENT 60  // Acima disso, envia a tela inteira
+
+// 1 = ssd1306_send_data_async() envia por DMA direto para a FIFO TX do I2C
+// 0 = ssd1306_send_data_async() usa i2c_write_blocking
+#ifndef SSD1306_USE_DMA
+#define SSD1306_USE_DMA 1
+#endif
+
+typedef void (*ssd1306_done_cb_t)(void *arg, bool ok); // ok = false: o display não respondeu (NACK)
+
 typedef enum {
   SET_CONTRAST = 0x81,
   SET_ENTIRE_ON = 0xA4,
@@ -35,12 +47,31 @@ typedef struct {
   uint8_t *ram_buffer;
   size_t bufsize;
   uint8_t port_buffer[2];
+  uint8_t dirty_x0[SSD1306_MAX_PAGES]; // Primeira coluna alterada por página desde o último envio
+  uint8_t dirty_x1[SSD1306_MAX_PAGES]; // Última coluna alterada por página (x0 > x1 = página limpa)
+  uint8_t *tx_buffer;                  // Transação I2C de uma janela: endereçamento + dados
+  uint8_t *sent_buffer;                // Cópia do conteúdo já enviado ao display (mesmo layout do ram_buffer)
+  bool sent_valid;                     // sent_buffer reflete o display (falso até o primeiro envio completo)
+  uint16_t *dma_buffer;                // Palavras DATA_CMD (byte + RESTART/STOP) lidas pelo DMA
+  int dma_chan;                        // Canal DMA (-1 até o primeiro envio assíncrono)
+  volatile bool busy;                  // Envio assíncrono em andamento
+  volatile bool flush_pending;         // Pedido de envio recebido durante a transferência
+  volatile bool aborted;               // Último envio abortado: o próximo reenvia a tela inteira
+  ssd1306_done_cb_t done_cb;
+  void *done_arg;
 } ssd1306_t;
 
 void ssd1306_init(ssd1306_t *ssd, uint8_t width, uint8_t height, bool external_vcc, uint8_t address, i2c_inst_t *i2c);
 void ssd1306_config(ssd1306_t *ssd);
 void ssd1306_command(ssd1306_t *ssd, uint8_t command);
-void ssd1306_send_data(ssd1306_t *ssd);
+void ssd1306_send_data(ssd1306_t *ssd);  // Envia somente as janelas alteradas
+void ssd1306_send_full(ssd1306_t *ssd);  // Envia a tela inteira
+void ssd1306_invalidate(ssd1306_t *ssd); // Marca a tela inteira como alterada
+bool ssd1306_send_data_async(ssd1306_t *ssd); // Envia as janelas alteradas sem bloquear
+void ssd1306_set_done_callback(ssd1306_t *ssd, ssd1306_done_cb_t cb, void *arg);
+bool ssd1306_is_busy(const ssd1306_t *ssd);
+bool ssd1306_flush_pending(const ssd1306_t *ssd);
+void ssd1306_wait(ssd1306_t *ssd);
 
 void ssd1306_pixel(ssd1306_t *ssd, uint8_t x, uint8_t y, bool value);
 void ssd1306_fill(ssd1306_t *ssd, bool value);
@@ -0,0 +1,67 @@
+#include "trace.h"
+
+trace_buffer_t trace_buffer;
+
+static uint8_t *trace_put_u16(uint8_t *p, uint16_t value)
+{
+    *p++ = value >> 8;
+    *p++ = value;
+    return p;
+}
+
+static uint8_t *trace_put_u32(uint8_t *p, uint32_t value)
+{
+    *p++ = value >> 24;
+    *p++ = value >> 16;
+    *p++ = value >> 8;
+    *p++ = value;
+    return p;
+}
+
+void trace_pause(bool paused)
+{
+    trace_buffer.paused = paused;
+}
+
+uint16_t trace_count(void)
+{
+    return trace_buffer.head < TRACE_BUFFER_EVENTS ? trace_buffer.head : TRACE_BUFFER_EVENTS;
+}
+
+uint32_t trace_overwritten(void)
+{
+    return trace_buffer.head - trace_count();
+}
+
+size_t trace_encode(uint16_t offset, uint16_t count, uint8_t *buffer, size_t size)
+{
+    if (size < TRACE_DUMP_HEADER)
+        return 0;
+
+    uint16_t total = trace_count();
+    if (offset > total)
+        offset = total;
+    if (count > total - offset)
+        count = total - offset;
+    if (size < TRACE_DUMP_HEADER + (size_t)count * TRACE_EVENT_BYTES)
+        count = (size - TRACE_DUMP_HEADER) / TRACE_EVENT_BYTES;
+
+    uint8_t *p = buffer;
+    *p++ = TRACE_DUMP_FORMAT;
+    p = trace_put_u16(p, total);
+    p = trace_put_u16(p, offset);
+    p = trace_put_u16(p, count);
+    p = trace_put_u32(p, trace_overwritten());
+
+    // O mais antigo fica na posição head quando o buffer já deu a volta
+    uint32_t first = trace_buffer.head - total;
+    for (uint16_t i = 0; i < count; i++)
+    {
+        const trace_event_t *event = &trace_buffer.events[(first + offset + i) % TRACE_BUFFER_EVENTS];
+        p = trace_put_u32(p, event->timestamp_us);
+        p = trace_put_u16(p, event->id);
+        p = trace_put_u16(p, event->arg0);
+        p = trace_put_u32(p, event->arg1);
+    }
+    return p - buffer;
+}
@@ -0,0 +1,85 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <stdlib.h>
+#include "pico/stdlib.h"
+#include "hardware/sync.h"
+
+// Registro binário de eventos em um buffer circular na RAM, para reconstruir a sequência exata
+// de interrupções, callbacks e workers sem o custo (e a distorção de tempo) de um printf.
+// Cada evento ocupa uma posição reservada com as interrupções desligadas por poucas instruções;
+// quando o buffer enche, os eventos mais antigos são sobrescritos.
+
+// 0 remove todos os pontos de TRACE_EVENT
+#ifndef TRACE_ENABLED
+#define TRACE_ENABLED 1
+#endif
+
+#ifndef TRACE_BUFFER_EVENTS
+#define TRACE_BUFFER_EVENTS 256 // Eventos guardados (potência de 2), 12 bytes cada
+#endif
+
+// Evento codificado (inteiros em big-endian): instante em us (4 bytes), id (2), arg0 (2), arg1 (4)
+#define TRACE_EVENT_BYTES 12
+
+// Cabeçalho de cada parte do dump (inteiros em big-endian):
+//   formato (1 byte), eventos no dump (2), posição do primeiro evento desta parte (2),
+//   eventos nesta parte (2), eventos sobrescritos antes do dump (4)
+#define TRACE_DUMP_FORMAT 1
+#define TRACE_DUMP_HEADER 11
+
+typedef struct
+{
+    uint32_t timestamp_us; // time_us_32 no momento do evento
+    uint16_t id;
+    uint16_t arg0;
+    uint32_t arg1;
+} trace_event_t;
+
+typedef struct
+{
+    trace_event_t events[TRACE_BUFFER_EVENTS];
+    uint32_t head;       // Eventos gravados desde o início (a posição é head % TRACE_BUFFER_EVENTS)
+    uint32_t skipped;    // Eventos ignorados com o registro pausado
+    volatile bool paused; // Pausado durante o dump, para o conteúdo não mudar no meio do envio
+} trace_buffer_t;
+
+extern trace_buffer_t trace_buffer;
+
+// Grava um evento; pode ser chamada de interrupções
+static inline void trace_record(uint16_t id, uint16_t arg0, uint32_t arg1)
+{
+    uint32_t irq_state = save_and_disable_interrupts();
+    if (trace_buffer.paused)
+    {
+        trace_buffer.skipped++;
+        restore_interrupts(irq_state);
+        return;
+    }
+    trace_event_t *event = &trace_buffer.events[trace_buffer.head++ % TRACE_BUFFER_EVENTS];
+    event->timestamp_us = time_us_32();
+    event->id = id;
+    event->arg0 = arg0;
+    event->arg1 = arg1;
+    restore_interrupts(irq_state);
+}
+
+#if TRACE_ENABLED
+#define TRACE_EVENT(id, arg0, arg1) trace_record((id), (uint16_t)(arg0), (uint32_t)(arg1))
+#else
+// Os argumentos continuam referenciados (sem avisos de variável não usada), mas a chamada é removida
+#define TRACE_EVENT(id, arg0, arg1)                                       \
+    do                                                                    \
+    {                                                                     \
+        if (0)                                                            \
+            trace_record((id), (uint16_t)(arg0), (uint32_t)(arg1));       \
+    } while (0)
+#endif
+
+void trace_pause(bool paused);
+uint16_t trace_count(void);       // Eventos disponíveis no buffer
+uint32_t trace_overwritten(void); // Eventos perdidos por sobrescrita
+// Codifica uma parte do dump: "count" eventos a partir do "offset"-ésimo mais antigo; retorna o tamanho
+size_t trace_encode(uint16_t offset, uint16_t count, uint8_t *buffer, size_t size);
+
+#endif // TRACE_H
@@ -1,10 +1,114 @@
 #include "ws2812b.h"
 #include "ws2812b.pio.h"
 
+#if WS2812B_USE_DMA
+#include "hardware/dma.h"
+#include "hardware/irq.h"
+#include "hardware/sync.h"
+#endif
+
 ws2812b_LED_t led_matrix[LED_MATRIX_SIZE];
 PIO led_matrix_pio;
 uint sm;
 
+static bool led_matrix_dirty = false; // Indica que o buffer difere do último quadro transmitido
+
+#if WS2812B_USE_DMA
+static uint32_t led_matrix_words[LED_MATRIX_SIZE]; // Quadro empacotado (GRB, 24 bits por LED) lido pelo DMA
+static int led_matrix_dma_chan = -1;                 // Canal DMA que alimenta a FIFO da máquina PIO
+static volatile bool led_matrix_busy = false;        // Transferência ou latch de RESET em andamento
+static volatile bool led_matrix_pending = false;     // Novo quadro solicitado durante uma transferência
+static ws2812b_done_cb_t led_matrix_done_cb = NULL;
+static void *led_matrix_done_arg = NULL;
+
+static void ws2812b_start_dma();
+
+// Fim do sinal de RESET: libera o barramento ou envia o quadro que ficou pendente.
+static int64_t ws2812b_latch_done(alarm_id_t id, void *user_data)
+{
+    if (led_matrix_pending)
+    {
+        led_matrix_pending = false;
+        ws2812b_start_dma();
+        return 0;
+    }
+
+    led_matrix_busy = false;
+    if (led_matrix_done_cb)
+        led_matrix_done_cb(led_matrix_done_arg);
+    return 0;
+}
+
+// Fim do DMA: as últimas palavras ainda estão na FIFO, então o RESET é contado por um alarme.
+static void ws2812b_dma_irq_handler()
+{
+    if (led_matrix_dma_chan < 0 || !dma_channel_get_irq0_status(led_matrix_dma_chan))
+        return;
+
+    dma_channel_acknowledge_irq0(led_matrix_dma_chan);
+    if (add_alarm_in_us(WS2812B_DRAIN_US + WS2812B_RESET_US, ws2812b_latch_done, NULL, true) < 0)
+    {
+        busy_wait_us(WS2812B_DRAIN_US + WS2812B_RESET_US); // Sem alarmes livres: espera no próprio IRQ
+        ws2812b_latch_done(0, NULL);
+    }
+}
+
+// Empacota o buffer de pixels e dispara a transferência DMA para a máquina PIO.
+static void ws2812b_start_dma()
+{
+    for (uint i = 0; i < LED_MATRIX_SIZE; ++i)
+    {
+        // Mesma ordem de bits do modo de 8 bits: G, R e B, deslocados para a direita.
+        led_matrix_words[i] = led_matrix[i].G | ((uint32_t)led_matrix[i].R << 8) | ((uint32_t)led_matrix[i].B << 16);
+    }
+    led_matrix_dirty = false;
+    dma_channel_transfer_from_buffer_now(led_matrix_dma_chan, led_matrix_words, LED_MATRIX_SIZE);
+}
+
+// Configura o canal DMA que escreve palavras de 32 bits na FIFO TX da máquina PIO.
+static void ws2812b_init_dma()
+{
+    led_matrix_dma_chan = dma_claim_unused_channel(true);
+
+    dma_channel_config c = dma_channel_get_default_config(led_matrix_dma_chan);
+    channel_config_set_transfer_data_size(&c, DMA_SIZE_32);
+    channel_config_set_read_increment(&c, true);
+    channel_config_set_write_increment(&c, false);
+    channel_config_set_dreq(&c, pio_get_dreq(led_matrix_pio, sm, true));
+    dma_channel_configure(led_matrix_dma_chan, &c, &led_matrix_pio->txf[sm], led_matrix_words, LED_MATRIX_SIZE, false);
+
+    dma_channel_set_irq0_enabled(led_matrix_dma_chan, true);
+    irq_add_shared_handler(DMA_IRQ_0, ws2812b_dma_irq_handler, PICO_SHARED_IRQ_HANDLER_DEFAULT_ORDER_PRIORITY);
+    irq_set_enabled(DMA_IRQ_0, true);
+}
+
+// Registra a função chamada (em contexto de interrupção) quando um quadro termina de ser exibido.
+void ws2812b_set_done_callback(ws2812b_done_cb_t cb, void *arg)
+{
+    led_matrix_done_cb = cb;
+    led_matrix_done_arg = arg;
+}
+
+// Indica se há um quadro sendo transmitido.
+bool ws2812b_is_busy()
+{
+    return led_matrix_busy;
+}
+#else
+// Registra a função chamada quando um quadro termina de ser exibido.
+void ws2812b_set_done_callback(ws2812b_done_cb_t cb, void *arg)
+{
+    (void)cb;
+    (void)arg;
+}
+
+// No modo bloqueante a transmissão termina dentro de ws2812b_write().
+bool ws2812b_is_busy()
+{
+    return false;
+}
+#endif
+
 // Inicializa a máquina PIO para controle da matriz de LEDs.
 void ws2812b_init(uint pin)
 {
@@ -22,7 +126,7 @@ void ws2812b_init(uint pin)
     }
 
     // Inicia programa na máquina PIO obtida.
-    led_matrix_program_init(led_matrix_pio, sm, offset, pin, 800000.f);
+    led_matrix_program_init(led_matrix_pio, sm, offset, pin, 800000.f, WS2812B_PULL_BITS);
 
     // Limpa buffer de pixels.
     for (uint i = 0; i < LED_MATRIX_SIZE; ++i)
@@ -31,11 +135,22 @@ void ws2812b_init(uint pin)
         led_matrix[i].G = 0;
         led_matrix[i].B = 0;
     }
+    led_matrix_dirty = true; // Estado físico dos LEDs é desconhecido até o primeiro commit
+
+#if WS2812B_USE_DMA
+    ws2812b_init_dma();
+#endif
 }
 
-// Atribui uma cor RGB a um LED.
+// Atribui uma cor RGB a um LED (apenas no buffer, sem transmitir).
 void ws2812b_set_led(const uint index, const uint8_t r, const uint8_t g, const uint8_t b)
 {
+    if (index >= LED_MATRIX_SIZE)
+        return;
+    if (led_matrix[index].R == r && led_matrix[index].G == g && led_matrix[index].B == b)
+        return;
+
+    led_matrix_dirty = true;
     led_matrix[index].R = r;
     led_matrix[index].G = g;
     led_matrix[index].B = b;
@@ -49,6 +164,24 @@ void ws2812b_clear()
 }
 
 // Escreve os dados do buffer nos LEDs.
+#if WS2812B_USE_DMA
+// Não bloqueia: se um quadro ainda estiver em trânsito, o atual é enviado logo em seguida.
+void ws2812b_write()
+{
+    uint32_t irq_state = save_and_disable_interrupts();
+    if (led_matrix_busy)
+    {
+        led_matrix_pending = true;
+        led_matrix_dirty = false;
+        restore_interrupts(irq_state);
+        return;
+    }
+    led_matrix_busy = true;
+    restore_interrupts(irq_state);
+
+    ws2812b_start_dma();
+}
+#else
 void ws2812b_write()
 {
     // Escreve cada dado de 8-bits dos pixels em sequência no buffer da máquina PIO.
@@ -58,36 +191,45 @@ void ws2812b_write()
         pio_sm_put_blocking(led_matrix_pio, sm, led_matrix[i].R);
         pio_sm_put_blocking(led_matrix_pio, sm, led_matrix[i].B);
     }
-    sleep_us(100); // Espera 100us, sinal de RESET do datasheet.
+    sleep_us(WS2812B_RESET_US); // Espera 100us, sinal de RESET do datasheet.
+    led_matrix_dirty = false;
+}
+#endif
+
+// Transmite o quadro montado no buffer apenas se ele mudou desde o último envio.
+bool ws2812b_commit()
+{
+    if (!led_matrix_dirty)
+        return false;
+
+    ws2812b_write();
+    return true;
 }
 
-// Desenha um ponto na matriz de LEDs.
-void ws2812b_draw_point(uint8_t point_index, const int color[3]) {
+// Indica se há alterações no buffer ainda não transmitidas.
+bool ws2812b_is_dirty()
+{
+    return led_matrix_dirty;
+}
+
+// Desenha um ponto no buffer da matriz de LEDs; use ws2812b_commit() para exibir.
+void ws2812b_draw_point(uint16_t point_index, const int color[3]) {
 
     ws2812b_set_led(point_index, color[0], color[1], color[2]);
+}
 
-    // Atualiza a matriz de LEDs.
-    ws2812b_write();
-    sleep_us(100); // Espera 100us
+// Converte (painel, linha, coluna) no índice do LED na cadeia, respeitando o padrão snake.
+uint16_t ws2812b_led_index(uint16_t panel, uint8_t row, uint8_t col) {
+    return WS2812B_LED_INDEX(panel, row, col);
 }
 
-// Preenche uma coluna da matriz de LEDs com uma cor específica.
-void ws2812b_fill_column(uint8_t column, const int color[3]) {
+// Preenche uma coluna da cadeia de LEDs com uma cor específica.
+void ws2812b_fill_column(uint16_t column, const int color[3]) {
     if (column >= LED_MATRIX_COL) return;
 
-    // Para uma matriz 5x5, mapeamento das posições na vertical:
-    for (int row = 0; row < LED_MATRIX_ROW; row++) {
-        int led_index;
-
-        // Mapeamento correto para padrão snake
-        if (row % 2 == 0) {
-            // Linha par: esquerda para direita
-            led_index = row * LED_MATRIX_ROW + column;
-        } else {
-            // Linha ímpar: direita para esquerda
-            led_index = row * LED_MATRIX_ROW + (LED_MATRIX_ROW - 1 - column);
-        }
+    uint16_t panel = column / LED_PANEL_COLS;
+    uint8_t panel_col = column % LED_PANEL_COLS;
 
-        ws2812b_set_led(led_index, color[0], color[1], color[2]);
-    }
+    for (uint8_t row = 0; row < LED_PANEL_ROWS; row++)
+        ws2812b_set_led(ws2812b_led_index(panel, row, panel_col), color[0], color[1], color[2]);
 }
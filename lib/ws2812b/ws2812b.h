@@ -7,9 +7,79 @@
 #include "pico/stdlib.h"
 
 
-#define LED_MATRIX_ROW 5
-#define LED_MATRIX_COL 5
-#define LED_MATRIX_SIZE (LED_MATRIX_ROW * LED_MATRIX_COL) // 5x5 = 25 LEDs
+// Geometria de um painel e quantidade de painéis encadeados na mesma linha de dados.
+// Os painéis são vistos lado a lado: a coluna global c fica no painel c / LED_PANEL_COLS.
+#ifndef LED_PANEL_ROWS
+#define LED_PANEL_ROWS 5
+#endif
+#ifndef LED_PANEL_COLS
+#define LED_PANEL_COLS 5
+#endif
+#ifndef LED_PANEL_COUNT
+#define LED_PANEL_COUNT 1
+#endif
+
+#define LED_PANEL_SIZE (LED_PANEL_ROWS * LED_PANEL_COLS)     // 5x5 = 25 LEDs por painel
+#define LED_MATRIX_ROW LED_PANEL_ROWS
+#define LED_MATRIX_COL (LED_PANEL_COLS * LED_PANEL_COUNT)
+#define LED_MATRIX_SIZE (LED_PANEL_SIZE * LED_PANEL_COUNT)   // Total de LEDs na cadeia
+
+// Índice na cadeia do LED (linha, coluna) de um painel ligado em serpentina:
+// linhas pares da esquerda para a direita, ímpares da direita para a esquerda.
+// É uma expressão constante, podendo ser usada para montar tabelas em flash.
+#define WS2812B_LED_INDEX(panel, row, col) \
+    ((panel) * LED_PANEL_SIZE + (row) * LED_PANEL_COLS + (((row) & 1) ? (LED_PANEL_COLS - 1 - (col)) : (col)))
+
+// Repete m(0) ... m(n - 1) em tempo de compilação (n literal, até 32), para gerar tabelas por painel.
+#define WS2812B_REPEAT(n, m) WS2812B_REPEAT_(n, m)
+#define WS2812B_REPEAT_(n, m) WS2812B_REPEAT_##n(m)
+#define WS2812B_REPEAT_1(m) m(0)
+#define WS2812B_REPEAT_2(m) WS2812B_REPEAT_1(m) m(1)
+#define WS2812B_REPEAT_3(m) WS2812B_REPEAT_2(m) m(2)
+#define WS2812B_REPEAT_4(m) WS2812B_REPEAT_3(m) m(3)
+#define WS2812B_REPEAT_5(m) WS2812B_REPEAT_4(m) m(4)
+#define WS2812B_REPEAT_6(m) WS2812B_REPEAT_5(m) m(5)
+#define WS2812B_REPEAT_7(m) WS2812B_REPEAT_6(m) m(6)
+#define WS2812B_REPEAT_8(m) WS2812B_REPEAT_7(m) m(7)
+#define WS2812B_REPEAT_9(m) WS2812B_REPEAT_8(m) m(8)
+#define WS2812B_REPEAT_10(m) WS2812B_REPEAT_9(m) m(9)
+#define WS2812B_REPEAT_11(m) WS2812B_REPEAT_10(m) m(10)
+#define WS2812B_REPEAT_12(m) WS2812B_REPEAT_11(m) m(11)
+#define WS2812B_REPEAT_13(m) WS2812B_REPEAT_12(m) m(12)
+#define WS2812B_REPEAT_14(m) WS2812B_REPEAT_13(m) m(13)
+#define WS2812B_REPEAT_15(m) WS2812B_REPEAT_14(m) m(14)
+#define WS2812B_REPEAT_16(m) WS2812B_REPEAT_15(m) m(15)
+#define WS2812B_REPEAT_17(m) WS2812B_REPEAT_16(m) m(16)
+#define WS2812B_REPEAT_18(m) WS2812B_REPEAT_17(m) m(17)
+#define WS2812B_REPEAT_19(m) WS2812B_REPEAT_18(m) m(18)
+#define WS2812B_REPEAT_20(m) WS2812B_REPEAT_19(m) m(19)
+#define WS2812B_REPEAT_21(m) WS2812B_REPEAT_20(m) m(20)
+#define WS2812B_REPEAT_22(m) WS2812B_REPEAT_21(m) m(21)
+#define WS2812B_REPEAT_23(m) WS2812B_REPEAT_22(m) m(22)
+#define WS2812B_REPEAT_24(m) WS2812B_REPEAT_23(m) m(23)
+#define WS2812B_REPEAT_25(m) WS2812B_REPEAT_24(m) m(24)
+#define WS2812B_REPEAT_26(m) WS2812B_REPEAT_25(m) m(25)
+#define WS2812B_REPEAT_27(m) WS2812B_REPEAT_26(m) m(26)
+#define WS2812B_REPEAT_28(m) WS2812B_REPEAT_27(m) m(27)
+#define WS2812B_REPEAT_29(m) WS2812B_REPEAT_28(m) m(28)
+#define WS2812B_REPEAT_30(m) WS2812B_REPEAT_29(m) m(29)
+#define WS2812B_REPEAT_31(m) WS2812B_REPEAT_30(m) m(30)
+#define WS2812B_REPEAT_32(m) WS2812B_REPEAT_31(m) m(31)
+
+// 1 = quadro enviado por DMA em palavras GRB de 24 bits, sem ocupar a CPU
+// 0 = quadro enviado byte a byte com pio_sm_put_blocking
+#ifndef WS2812B_USE_DMA
+#define WS2812B_USE_DMA 1
+#endif
+
+#if WS2812B_USE_DMA
+#define WS2812B_PULL_BITS 24 // Autopull de um pixel inteiro por palavra
+#else
+#define WS2812B_PULL_BITS 8  // Autopull de uma cor por palavra
+#endif
+
+#define WS2812B_RESET_US 100        // Tempo mínimo de RESET (latch) do datasheet
+#define WS2812B_DRAIN_US (9 * 30)   // FIFO unida (8 palavras) + OSR, 30us por pixel a 800kHz
 
 
 // Tipos de dados.
@@ -24,11 +94,18 @@ extern ws2812b_LED_t led_matrix[LED_MATRIX_SIZE]; // Declaração do buffer de p
 extern PIO led_matrix_pio;                     // Ponteiro para a máquina PIO.
 extern uint sm;                        // Número da máquina state machine.
 
+typedef void (*ws2812b_done_cb_t)(void *arg); // Chamada em contexto de interrupção ao fim do RESET
+
 void ws2812b_init(uint pin);
 void ws2812b_set_led(const uint index, const uint8_t r, const uint8_t g, const uint8_t b);
 void ws2812b_clear();
-void ws2812b_write();
-void ws2812b_draw_point(uint8_t number_index, const int color[3]);
-void ws2812b_fill_column(uint8_t column, const int color[3]);
+void ws2812b_write();  // Transmite o buffer inteiro incondicionalmente
+bool ws2812b_commit(); // Transmite o buffer uma única vez, somente se houver alterações
+bool ws2812b_is_dirty();
+bool ws2812b_is_busy();
+void ws2812b_set_done_callback(ws2812b_done_cb_t cb, void *arg);
+void ws2812b_draw_point(uint16_t number_index, const int color[3]);
+void ws2812b_fill_column(uint16_t column, const int color[3]);
+uint16_t ws2812b_led_index(uint16_t panel, uint8_t row, uint8_t col);
 
 #endif // WS2812B_H
@@ -1,6 +1,7 @@
 #include "pico/stdlib.h"     // Biblioteca da Raspberry Pi Pico para funções padrão (GPIO, temporização, etc.)
 #include "pico/cyw43_arch.h" // Biblioteca para arquitetura Wi-Fi da Pico com CYW43
 #include "pico/unique_id.h"  // Biblioteca com recursos para trabalhar com os pinos GPIO do Raspberry Pi Pico
+#include "pico/rand.h"       // Números aleatórios (jitter da reconexão)
 
 #include "hardware/gpio.h" // Biblioteca de hardware de GPIO
 #include "hardware/irq.h"  // Biblioteca de hardware de interrupções
@@ -16,6 +17,22 @@
 #include "lib/button/button.h"
 #include "lib/ws2812b/ws2812b.h"
 #include "lib/buzzer/buzzer.h"
+#include "lib/parking/expiry_heap.h"
+#include "lib/parking/parking_store.h"
+#include "lib/parking/parking_snapshot.h"
+#include "lib/parking/parking_journal.h"
+#include "lib/parking/parking_batch.h"
+#include "lib/mqtt/publish_queue.h"
+#include "lib/mqtt/topic_router.h"
+#include "lib/mqtt/payload_assembler.h"
+#include "lib/metrics/latency_histogram.h"
+#include "lib/trace/trace.h"
+#include "lib/log/log.h"
+#ifdef PARKING_STORE_BENCH
+#include "lib/parking/parking_store_bench.h"
+#endif
+#include "src/parking_layout.h"
+#include "src/trace_ids.h"
 #include "config/credential_config.h" // Inclua suas credenciais de configuração
 
 #ifndef MQTT_SERVER
@@ -31,37 +48,96 @@
 #define MQTT_TOPIC_LEN 100
 #endif
 
+// Etapas da conexão com o broker
+typedef enum
+{
+    MQTT_STATE_IDLE,       // Aguardando o primeiro agendamento
+    MQTT_STATE_RESOLVING,  // Consultando o DNS
+    MQTT_STATE_CONNECTING, // Conexão TCP/TLS e CONNECT em andamento
+    MQTT_STATE_CONNECTED,  // Conectado e assinado
+    MQTT_STATE_BACKOFF,    // Aguardando a próxima tentativa
+} mqtt_state_t;
+
 // Dados do cliente MQTT
 typedef struct
 {
     mqtt_client_t *mqtt_client_inst;
     struct mqtt_connect_client_info_t mqtt_client_info;
-    char data[MQTT_OUTPUT_RINGBUF_SIZE];
-    char topic[MQTT_TOPIC_LEN];
-    uint32_t len;
+    payload_assembler_t payload;                   // Montagem do payload da mensagem recebida
+    const topic_route_t *route;                    // Rota da mensagem recebida (NULL se nenhuma)
+    int32_t route_params[TOPIC_ROUTER_MAX_PARAMS]; // Valores dos "+" do tópico recebido
+    uint8_t topic_prefix_len;                      // Prefixo "/<client_id>" dos tópicos (MQTT_UNIQUE_TOPIC)
     ip_addr_t mqtt_server_address;
     bool connect_done;
     int subscribe_count;
     bool stop_client;
+    publish_queue_t publish_queue; // Mensagens aguardando espaço no cliente MQTT
+    mqtt_state_t mqtt_state;         // Etapa da (re)conexão
+    uint32_t backoff_ms;             // Intervalo base da próxima tentativa
+    absolute_time_t disconnected_at; // Início da queda atual (nil_time se conectado)
+    uint32_t reconnects;             // Reconexões bem sucedidas
+    uint32_t recover_ms;             // Duração da última queda
+    uint32_t max_recover_ms;         // Maior queda observada
+    absolute_time_t connect_started; // Início da conexão em andamento (TCP + TLS + CONNECT)
+    uint32_t connect_ms;             // Duração da última conexão aceita
+    bool tls_resume_offered;         // A última conexão ofereceu uma sessão TLS anterior
 } MQTT_CLIENT_DATA_T;
 
+// As mensagens vão para o log adiado (lib/log): o stdio só é escrito com o loop ocioso
 #ifndef DEBUG_printf
-#ifndef NDEBUG
-#define DEBUG_printf printf
-#else
-#define DEBUG_printf(...)
-#endif
+#define DEBUG_printf LOG_DEBUG
 #endif
 
 #ifndef INFO_printf
-#define INFO_printf printf
+#define INFO_printf LOG_INFO
 #endif
 
 #ifndef ERROR_printf
-#define ERROR_printf printf
+#define ERROR_printf LOG_ERROR
 #endif
 
-#define TEMP_WORKER_TIME_S 10
+#ifndef WARN_printf
+#define WARN_printf LOG_WARN
+#endif
+
+#define LOG_DRAIN_RETRY_MS 1 // Espera entre escoamentos enquanto ainda houver log guardado
+
+#define TEMP_WORKER_TIME_S 10 // Intervalo do heartbeat
+
+// Maior payload montado em buffer; rotas de streaming podem aceitar mensagens maiores
+#ifndef MQTT_PAYLOAD_MAX_LEN
+#define MQTT_PAYLOAD_MAX_LEN 256
+#endif
+
+// Janela de agrupamento das publicações: mudanças dentro da janela saem em uma única publicação.
+// A janela é reiniciada a cada mudança, mas nunca atrasa a publicação mais que PUBLISH_COALESCE_MAX_MS
+#ifndef PUBLISH_COALESCE_MS
+#define PUBLISH_COALESCE_MS 50
+#endif
+#ifndef PUBLISH_COALESCE_MAX_MS
+#define PUBLISH_COALESCE_MAX_MS 200
+#endif
+
+// Intervalo da ressincronização completa (todas as vagas são republicadas); 0 desativa
+#ifndef PARKING_RESYNC_S
+#define PARKING_RESYNC_S 300
+#endif
+
+// Histogramas de latência dos caminhos quentes, publicados em /metrics a cada PARKING_METRICS_INTERVAL_S;
+// 0 remove as medições
+#ifndef PARKING_METRICS
+#define PARKING_METRICS 1
+#endif
+#ifndef PARKING_METRICS_INTERVAL_S
+#define PARKING_METRICS_INTERVAL_S 60
+#endif
+#define PARKING_METRICS_FORMAT 1
+
+#define TRACE_DUMP_CHUNK_EVENTS 64 // Eventos por mensagem do dump do trace (/trace)
+
+// Espera entre tentativas de reconexão: dobra a cada falha, com jitter, até o máximo
+#define MQTT_RECONNECT_MIN_MS 1000
+#define MQTT_RECONNECT_MAX_MS 60000
 
 // Manter o programa ativo - keep alive in seconds
 #define MQTT_KEEP_ALIVE_S 60
@@ -73,6 +149,16 @@ typedef struct
 #define MQTT_SUBSCRIBE_QOS 1
 #define MQTT_PUBLISH_QOS 1
 #define MQTT_PUBLISH_RETAIN 0
+#define MQTT_HEARTBEAT_QOS 0 // Heartbeat pode ser perdido: o próximo chega em 10 s
+#define MQTT_SNAPSHOT_RETAIN 1 // O snapshot fica retido para novos assinantes
+#define PARKING_JOURNAL_BATCH 128 // Transições por mensagem de replay do journal
+
+// Formas de publicar o status das vagas (combináveis)
+#define PARKING_PUBLISH_PER_LOT 1  // Um tópico por vaga: /parking/status/<id>
+#define PARKING_PUBLISH_SNAPSHOT 2 // Todas as vagas em uma única mensagem binária: /parking/snapshot
+#ifndef PARKING_PUBLISH_MODE
+#define PARKING_PUBLISH_MODE (PARKING_PUBLISH_PER_LOT | PARKING_PUBLISH_SNAPSHOT)
+#endif
 
 // Tópico usado para: last will and testament
 #define MQTT_WILL_TOPIC "/online"
@@ -89,15 +175,25 @@ typedef struct
 #endif
 
 #define CYW43_LED_PIN CYW43_WL_GPIO_LED_PIN // GPIO do CI CYW43
-#define PARKING_LOT_SIZE 4                  // Tamanho do estacionamento
+#ifndef PARKING_LOT_SIZE
+#define PARKING_LOT_SIZE 4                  // Tamanho do estacionamento (suporta milhares de vagas)
+#endif
+// Reservas simultâneas (só as vagas reservadas ocupam espaço na tabela de prazos)
+#ifndef PARKING_MAX_RESERVATIONS
+#define PARKING_MAX_RESERVATIONS (PARKING_LOT_SIZE < 256 ? PARKING_LOT_SIZE : 256)
+#endif
+#define PARKING_DISPLAY_LINES 4             // Vagas listadas no display de cada vez
+// Vagas exibidas na cadeia de LEDs (as excedentes aparecem apenas no display e no MQTT)
+#define PARKING_MATRIX_LOTS (PARKING_LOT_SIZE < PARKING_LED_LOTS ? PARKING_LOT_SIZE : PARKING_LED_LOTS)
 #define LED_MATRIX_PIN 7                    // GPIO da matriz de LEDs
-
-typedef struct parking_lot
-{
-    uint8_t id;                             // ID do estacionamento
-    uint8_t status;                         // Status do estacionamento (0 - livre, 1 - ocupado, 2 - reservado)
-    absolute_time_t reservation_start_time; // Hora de início da reserva
-} parking_lot_t;
+#define RESERVATION_TIMEOUT_MS 10000        // Duração de uma reserva
+// Itens por comando em lote (/parking/batch)
+#ifndef PARKING_BATCH_MAX_ITEMS
+#define PARKING_BATCH_MAX_ITEMS (PARKING_LOT_SIZE < 256 ? PARKING_LOT_SIZE : 256)
+#endif
+#define BATCH_REPLY_QUEUE 8                 // Respostas de lote aguardando espaço no cliente MQTT
+#define BUZZER_TONE_MS 250                  // Duração do aviso sonoro de mudança de status
+#define BUZZER_GAP_MS 50                    // Pausa entre avisos consecutivos
 
 // Prototipos de funções
 // Inicializa o estacionamento
@@ -106,14 +202,20 @@ void init_parking_lots(void);
 // Atualiza o LED RGB de acordo com a quantidade de vagas livres
 void update_led_rgb();
 
-// Atualiza a matriz de LEDs
+// Redesenha a matriz de LEDs inteira
 void update_led_matrix(void);
 
+// Redesenha na matriz de LEDs somente os LEDs de uma vaga
+void draw_parking_lot(uint16_t lot);
+
 // Atualiza o display OLED
 void update_display();
 
-// Atualiza o buzzer
-void update_buzzer();
+// Toca o aviso sonoro do status de uma vaga
+void update_buzzer(uint16_t lot);
+
+// Altera o status de uma vaga; sem conexão com o broker a transição vai para o journal
+static bool set_lot_status(uint16_t lot, uint8_t status);
 
 // Atualiza os sinais de saída
 void update_outputs();
@@ -121,15 +223,108 @@ void update_outputs();
 // Função de callback para os botões GPIO
 void gpio_callback_handler(uint gpio, uint32_t events);
 
-// Requisição para publicar
-static void pub_request_cb(__unused void *arg, err_t err);
+// Worker que expira as reservas, armado para o prazo mais próximo da heap
+static void reservation_worker_fn(async_context_t *context, async_at_time_worker_t *worker);
+static async_at_time_worker_t reservation_worker = {.do_work = reservation_worker_fn};
+
+// Agenda a expiração da reserva de uma vaga e rearma o worker
+static bool schedule_reservation_expiry(uint16_t index, absolute_time_t start, uint32_t duration_ms);
+
+// Cancela a expiração de uma vaga que deixou de estar reservada
+static void cancel_reservation_expiry(uint16_t index);
+
+// Reserva recebida por MQTT e aplicada: inicia a medição até o display
+static void reservation_applied(void);
+
+// Worker que consome os eventos dos botões registrados pela interrupção
+static void button_worker_fn(async_context_t *context, async_when_pending_worker_t *worker);
+static async_when_pending_worker_t button_worker = {.do_work = button_worker_fn};
+
+// Chaves das mensagens da fila de publicação (a mais recente substitui a anterior)
+enum
+{
+    PUBLISH_KEY_ONLINE = 1,
+    PUBLISH_KEY_UPTIME,
+    PUBLISH_KEY_FREE,
+    PUBLISH_KEY_RECOVERY,
+};
+
+// Uma requisição MQTT terminou: retoma a fila e as vagas pendentes
+static void publish_slot_freed(void *arg);
+
+// Enfileira uma mensagem curta e tenta enviá-la
+static void publish_message(MQTT_CLIENT_DATA_T *state, uint16_t key, const char *topic, const char *msg, uint8_t qos, bool retain);
 
 // Topico MQTT
 static const char *full_topic(MQTT_CLIENT_DATA_T *state, const char *name);
 
-// Publicar status do estacionamento
+// Confirmação da publicação do status de uma vaga
+static void status_pub_request_cb(void *arg, err_t err);
+
+// Confirmação da publicação do snapshot
+static void snapshot_pub_request_cb(void *arg, err_t err);
+
+// Confirmação de um lote do journal
+static void journal_pub_request_cb(void *arg, err_t err);
+
+// Latências medidas; o valor é o id do histograma em /metrics
+typedef enum
+{
+    METRIC_GPIO_IRQ,               // Interrupção dos botões
+    METRIC_UPDATE_OUTPUTS,         // update_outputs
+    METRIC_DISPLAY_SEND,           // Transferência DMA do display, do início ao fim
+    METRIC_LED_MATRIX_WRITE,       // Envio do quadro da matriz de LEDs
+    METRIC_PUBLISH_STATUS,         // publish_parking_status
+    METRIC_PUBLISH_RTT,            // Publicação do status de uma vaga até a confirmação do broker
+    METRIC_PRESS_TO_ACK,           // Botão pressionado até o broker confirmar o novo status
+    METRIC_RESERVATION_TO_DISPLAY, // Reserva recebida até o fim do envio do display que a mostra
+    METRIC_COUNT,
+} metric_id_t;
+
+// Registra no histograma o tempo decorrido desde start_us (time_us_32)
+static inline void metric_record(metric_id_t id, uint32_t start_us);
+
+// O broker confirmou uma publicação; carrier indica que ela foi marcada como a que leva o último toque
+static void press_acked(bool carrier);
+
+// Worker que publica os histogramas
+static void metrics_worker_fn(async_context_t *context, async_at_time_worker_t *worker);
+static async_at_time_worker_t metrics_worker = {.do_work = metrics_worker_fn};
+
+// Confirmação da publicação dos histogramas
+static void metrics_pub_request_cb(void *arg, err_t err);
+
+// Envia a próxima parte do dump do trace, se houver um em andamento
+static void publish_trace_dump(MQTT_CLIENT_DATA_T *state);
+
+// Confirmação de uma parte do dump do trace
+static void trace_pub_request_cb(void *arg, err_t err);
+
+// Publicar status das vagas alteradas desde a última publicação confirmada
 static void publish_parking_status(MQTT_CLIENT_DATA_T *state);
 
+// Força a republicação de todas as vagas e do snapshot
+static void request_full_resync(void);
+
+// Registra uma mudança de status a publicar ao fim da janela de agrupamento
+static void request_status_publish(void);
+
+// Worker que publica as mudanças agrupadas ao fim da janela
+static void publish_coalesce_worker_fn(async_context_t *context, async_at_time_worker_t *worker);
+static async_at_time_worker_t publish_coalesce_worker = {.do_work = publish_coalesce_worker_fn};
+
+// Contadores para ajustar a janela de agrupamento
+typedef struct
+{
+    uint32_t events;   // Mudanças de status recebidas
+    uint32_t flushes;  // Janelas encerradas
+    uint32_t messages; // Mensagens de status enviadas (por vaga e snapshots)
+} publish_stats_t;
+
+// Worker que continua a publicação quando uma confirmação libera espaço
+static void status_publish_worker_fn(async_context_t *context, async_when_pending_worker_t *worker);
+static async_when_pending_worker_t status_publish_worker = {.do_work = status_publish_worker_fn};
+
 // Requisição de Assinatura - subscribe
 static void sub_request_cb(void *arg, err_t err);
 
@@ -142,13 +337,51 @@ static void sub_unsub_topics(MQTT_CLIENT_DATA_T *state, bool sub);
 // Dados de entrada MQTT
 static void mqtt_incoming_data_cb(void *arg, const u8_t *data, u16_t len, u8_t flags);
 
+// Tratadores dos tópicos assinados
+static void handle_print(void *arg, const int32_t *params, const uint8_t *data, uint16_t len, uint8_t flags);
+static void handle_ping(void *arg, const int32_t *params, const uint8_t *data, uint16_t len, uint8_t flags);
+static void handle_exit(void *arg, const int32_t *params, const uint8_t *data, uint16_t len, uint8_t flags);
+static void handle_reservation(void *arg, const int32_t *params, const uint8_t *data, uint16_t len, uint8_t flags);
+static void handle_batch(void *arg, const int32_t *params, const uint8_t *data, uint16_t len, uint8_t flags);
+static void handle_trace_dump(void *arg, const int32_t *params, const uint8_t *data, uint16_t len, uint8_t flags);
+
+// Confirmação da resposta de um comando em lote
+static void batch_reply_pub_request_cb(void *arg, err_t err);
+
+// Envia as respostas de lote guardadas, em ordem, até o cliente recusar
+static void publish_batch_replies(MQTT_CLIENT_DATA_T *state);
+
+// Tópicos assinados e seus tratadores; a mesma tabela gera as assinaturas e a árvore de roteamento
+static const topic_route_t topic_routes[] = {
+    {"/print", handle_print, MQTT_PAYLOAD_MAX_LEN, false},
+    {"/ping", handle_ping, MQTT_PAYLOAD_MAX_LEN, false},
+    {"/exit", handle_exit, MQTT_PAYLOAD_MAX_LEN, false},
+    {"/parking/+/reservation", handle_reservation, MQTT_PAYLOAD_MAX_LEN, false},
+    {"/parking/batch", handle_batch, UINT32_MAX, true}, // O decodificador limita os itens e responde "itens demais"
+    {"/trace/dump", handle_trace_dump, MQTT_PAYLOAD_MAX_LEN, false},
+};
+static topic_router_t topic_router;
+static parking_batch_t batch; // Comando em lote sendo recebido
+static uint8_t batch_replies[BATCH_REPLY_QUEUE][PARKING_BATCH_REPLY_BYTES(PARKING_BATCH_MAX_ITEMS)];
+static uint16_t batch_reply_len[BATCH_REPLY_QUEUE];
+static uint8_t batch_reply_head = 0, batch_reply_count = 0; // Fila circular das respostas
+static uint32_t batch_replies_dropped = 0;                  // Respostas descartadas com a fila cheia
+
 // Dados de entrada publicados
 static void mqtt_incoming_publish_cb(void *arg, const char *topic, u32_t tot_len);
 
-// Worker para publicar o status do estacionamento
+// Worker do heartbeat e da ressincronização periódica
 static void parking_status_worker_fn(async_context_t *context, async_at_time_worker_t *worker);
 static async_at_time_worker_t parking_status_worker = {.do_work = parking_status_worker_fn};
 
+// Envia ao display as áreas alteradas e marca o início da transferência
+static void display_send(void);
+
+// Envio do display adiado enquanto uma transferência DMA estava em andamento
+static void display_flush_done(void *arg, bool ok);
+static void display_flush_worker_fn(async_context_t *context, async_when_pending_worker_t *worker);
+static async_when_pending_worker_t display_flush_worker = {.do_work = display_flush_worker_fn};
+
 // Conexão MQTT
 static void mqtt_connection_cb(mqtt_client_t *client, void *arg, mqtt_connection_status_t status);
 
@@ -158,13 +391,54 @@ static void start_client(MQTT_CLIENT_DATA_T *state);
 // Call back com o resultado do DNS
 static void dns_found(const char *hostname, const ip_addr_t *ipaddr, void *arg);
 
-static volatile parking_lot_t parking_lots[PARKING_LOT_SIZE]; // Array de estruturas para armazenar o status do estacionamento
-static volatile int8_t current_parking_lot = 0;               // Vaga de estacionamento atual
-static volatile int last_a = 0, last_b = 0, last_sw = 0;
-const int debounce = 270;                         // Tempo de debounce para os botões
-volatile bool publish_parking_status_flag = true; // Sinaliza para publicar o status do estacionamento
-static volatile int free_parking_lots = 0;
-static volatile int parking_lot_status[PARKING_LOT_SIZE] = {0};
+#if LWIP_ALTCP && LWIP_ALTCP_TLS
+// Sessão TLS da última conexão, oferecida ao broker na reconexão para evitar o handshake completo
+static struct altcp_tls_session *tls_session = NULL;
+static bool tls_session_valid = false;
+#endif
+
+// Agenda a próxima tentativa de conexão com backoff exponencial e jitter
+static void schedule_reconnect(MQTT_CLIENT_DATA_T *state);
+
+// Worker que verifica o Wi-Fi, resolve o DNS de novo e reconecta ao broker
+static void reconnect_worker_fn(async_context_t *context, async_at_time_worker_t *worker);
+static async_at_time_worker_t reconnect_worker = {.do_work = reconnect_worker_fn};
+
+PARKING_STORE_DEFINE(parking_store, PARKING_LOT_SIZE);                                 // Status das vagas (2 bits por vaga)
+EXPIRY_HEAP_DEFINE(reservation_expiry, PARKING_LOT_SIZE, PARKING_MAX_RESERVATIONS); // Prazos das reservas ativas
+static volatile uint16_t current_parking_lot = 0;                                      // Vaga de estacionamento atual
+const uint32_t debounce_us = 270 * 1000;                                               // Tempo de debounce para os botões
+static uint32_t snapshot_sequence = 0;                                                 // Número de sequência do último snapshot enviado
+static uint32_t snapshot_version;                                                      // Versão do estado contida nesse snapshot
+static bool snapshot_valid = false;                                                    // false força o envio de um novo snapshot
+static bool snapshot_in_flight = false;                                                // Snapshot aguardando confirmação
+static bool journal_in_flight = false;                                                 // Lote do journal aguardando confirmação
+static bool broker_online = false;                                                     // Conexão MQTT aceita e ativa
+static bool coalesce_armed = false;                                                    // Janela de agrupamento aberta
+static absolute_time_t coalesce_deadline;                                              // Limite da janela aberta
+static publish_stats_t publish_stats = {0};
+#if PARKING_METRICS
+static latency_histogram_t metrics[METRIC_COUNT];                                      // Latências acumuladas desde o boot
+#endif
+static bool metrics_in_flight = false;                                                 // Histogramas aguardando envio
+static uint32_t message_at_us;                                                         // Chegada da mensagem MQTT em tratamento
+static uint32_t press_at_us;                                                           // Botão aguardando confirmação do broker
+static uint16_t press_lot;                                                             // Vaga alterada por esse toque
+static bool press_pending = false;
+static bool press_sent = false;                                                        // Publicação que leva o toque em andamento
+static bool snapshot_press = false;                                                    // O snapshot em andamento é essa publicação
+static uint32_t reservation_at_us;                                                     // Reserva aguardando aparecer no display
+static volatile bool reservation_pending = false;
+static volatile bool reservation_sent = false;                                         // Envio do display que a inclui já começou
+static uint32_t display_send_at_us;                                                    // Início da transferência do display
+static uint32_t status_sent_at_us[MQTT_REQ_MAX_IN_FLIGHT];                             // Status aguardando confirmação, em ordem
+static bool status_sent_press[MQTT_REQ_MAX_IN_FLIGHT];                                 // O status nessa posição leva o toque pendente
+static uint8_t status_sent_head = 0;
+static uint8_t status_sent_count = 0;
+static bool trace_dump_active = false;                                                 // Dump do trace em andamento (registro pausado)
+static bool trace_dump_in_flight = false;                                              // Parte do dump aguardando confirmação
+static uint16_t trace_dump_offset = 0;                                                 // Próximo evento a enviar
+static uint16_t trace_dump_last = 0;                                                   // Eventos da última parte enviada
 ssd1306_t ssd;
 
 int main(void)
@@ -180,7 +454,11 @@ int main(void)
     init_display(&ssd); // Inicializa o display OLED
     init_buzzer(BUZZER_A_PIN, 4.0); // Inicializa o buzzer
 
+#ifdef PARKING_STORE_BENCH
+    parking_store_bench();
+#endif
 
+    update_led_matrix(); // Desenha todas as vagas uma vez
     update_outputs(); // Atualiza os LEDs e a matriz de LEDs
 
     INFO_printf("mqtt client starting\n");
@@ -194,6 +472,10 @@ int main(void)
         panic("Failed to inizialize CYW43");
     }
 
+    // Pedidos de redesenho feitos durante um envio DMA do display são atendidos no contexto assíncrono
+    async_context_add_when_pending_worker(cyw43_arch_async_context(), &display_flush_worker);
+    ssd1306_set_done_callback(&ssd, display_flush_done, NULL);
+
     // Usa identificador único da placa
     char unique_id_buf[5];
     pico_get_unique_board_id_string(unique_id_buf, sizeof(unique_id_buf));
@@ -224,8 +506,22 @@ int main(void)
     state.mqtt_client_info.will_msg = MQTT_WILL_MSG;
     state.mqtt_client_info.will_qos = MQTT_WILL_QOS;
     state.mqtt_client_info.will_retain = true;
+
+    // Árvore de roteamento dos tópicos assinados, montada uma única vez
+    if (!topic_router_init(&topic_router, topic_routes, count_of(topic_routes)))
+    {
+        panic("Topic router too small");
+    }
+    static uint8_t payload_buffer[MQTT_PAYLOAD_MAX_LEN];
+    payload_assembler_init(&state.payload, payload_buffer, sizeof(payload_buffer));
+    static parking_batch_item_t batch_items[PARKING_BATCH_MAX_ITEMS];
+    parking_batch_init(&batch, batch_items, PARKING_BATCH_MAX_ITEMS, PARKING_LOT_SIZE);
+#if MQTT_UNIQUE_TOPIC
+    state.topic_prefix_len = strlen(client_id_buf) + 1;
+#endif
 #if LWIP_ALTCP && LWIP_ALTCP_TLS
     // TLS enabled
+    // A configuração (e os certificados) é criada uma única vez e reaproveitada em todas as reconexões
 #ifdef MQTT_CERT_INC
     static const uint8_t ca_cert[] = TLS_ROOT_CERT;
     static const uint8_t client_key[] = TLS_CLIENT_KEY;
@@ -237,93 +533,80 @@ int main(void)
     WARN_printf("Warning: tls without verification is insecure\n");
 #endif
 #else
-    state->client_info.tls_config = altcp_tls_create_config_client(NULL, 0);
+    state.mqtt_client_info.tls_config = altcp_tls_create_config_client(NULL, 0);
     WARN_printf("Warning: tls without a certificate is insecure\n");
 #endif
+    tls_session = altcp_tls_alloc_session();
+#endif
+
+    // Expiração das reservas e eventos dos botões são tratados no mesmo contexto dos callbacks MQTT
+    // e continuam funcionando sem rede
+    publish_coalesce_worker.user_data = &state;
+    async_context_add_when_pending_worker(cyw43_arch_async_context(), &button_worker);
+    gpio_set_irq_enabled_with_callback(BTN_A_PIN, GPIO_IRQ_EDGE_FALL, true, &gpio_callback_handler);
+    gpio_set_irq_enabled(BTN_B_PIN, GPIO_IRQ_EDGE_FALL, true);
+    gpio_set_irq_enabled(BTN_SW_PIN, GPIO_IRQ_EDGE_FALL, true);
+
+    // Publicação contínua das vagas e heartbeat (não fazem nada enquanto desconectado)
+    status_publish_worker.user_data = &state;
+    async_context_add_when_pending_worker(cyw43_arch_async_context(), &status_publish_worker);
+    parking_status_worker.user_data = &state;
+    async_context_add_at_time_worker_in_ms(cyw43_arch_async_context(), &parking_status_worker, TEMP_WORKER_TIME_S * 1000);
+#if PARKING_METRICS
+    metrics_worker.user_data = &state;
+    async_context_add_at_time_worker_in_ms(cyw43_arch_async_context(), &metrics_worker, PARKING_METRICS_INTERVAL_S * 1000);
 #endif
 
-    // Conectar à rede WiFI - fazer um loop até que esteja conectado
+    // Conectar à rede WiFI; se falhar, o worker de reconexão continua tentando
     cyw43_arch_enable_sta_mode();
     if (cyw43_arch_wifi_connect_timeout_ms(WIFI_SSID, WIFI_PASSWORD, CYW43_AUTH_WPA2_AES_PSK, 30000))
     {
-        panic("Failed to connect");
+        ERROR_printf("Failed to connect to Wifi, retrying in background\n");
     }
-    INFO_printf("\nConnected to Wifi\n");
-
-    // Faz um pedido de DNS para o endereço IP do servidor MQTT
-    cyw43_arch_lwip_begin();
-    int err = dns_gethostbyname(MQTT_SERVER, &state.mqtt_server_address, dns_found, &state);
-    cyw43_arch_lwip_end();
-
-    // Se tiver o endereço, inicia o cliente
-    if (err == ERR_OK)
+    else
     {
-        start_client(&state);
-    }
-    else if (err != ERR_INPROGRESS)
-    { // ERR_INPROGRESS means expect a callback
-        panic("dns request failed");
+        INFO_printf("\nConnected to Wifi\n");
     }
 
-    gpio_set_irq_enabled_with_callback(BTN_A_PIN, GPIO_IRQ_EDGE_FALL, true, &gpio_callback_handler);
-    gpio_set_irq_enabled(BTN_B_PIN, GPIO_IRQ_EDGE_FALL, true);
-    gpio_set_irq_enabled(BTN_SW_PIN, GPIO_IRQ_EDGE_FALL, true);
+    // DNS, conexão e reconexões ficam a cargo do worker de reconexão
+    state.backoff_ms = MQTT_RECONNECT_MIN_MS;
+    state.disconnected_at = nil_time;
+    reconnect_worker.user_data = &state;
+    async_context_add_at_time_worker_in_ms(cyw43_arch_async_context(), &reconnect_worker, 0);
 
-    // Loop condicionado a conexão mqtt
-    while (!state.connect_done || mqtt_client_is_connected(state.mqtt_client_inst))
+    // Loop até que o encerramento seja pedido por /exit
+    while (!state.stop_client || (state.mqtt_client_inst && mqtt_client_is_connected(state.mqtt_client_inst)))
     {
         cyw43_arch_poll();
-        cyw43_arch_wait_for_work_until(make_timeout_time_ms(10000));
-
-        // Verifica expiração das reservas
-        for (int i = 0; i < PARKING_LOT_SIZE; i++)
-        {
-            if (parking_lots[i].status == 2)
-            {
-                int64_t diff_ms = absolute_time_diff_us(parking_lots[i].reservation_start_time, get_absolute_time()) / 1000;
-                if (diff_ms > 10000)
-                {
-                    parking_lots[i].status = 0;
-                    update_outputs();
-                    INFO_printf("Reserva da vaga %d expirada\n", i + 1);
-                }
-            }
-        }
-
-        if (publish_parking_status_flag)
-        {
-            update_outputs(); // Atualiza os LEDs e a matriz de LEDs
-            publish_parking_status(&state);
-            publish_parking_status_flag = false;
-        }
+        // Tempo ocioso: escreve parte do log guardado e volta logo se ainda sobrar
+        log_drain(LOG_DRAIN_BYTES);
+        cyw43_arch_wait_for_work_until(make_timeout_time_ms(log_pending() ? LOG_DRAIN_RETRY_MS : 10000));
+        TRACE_EVENT(TRACE_LOOP_WAKE, 0, 0);
     }
 
     INFO_printf("mqtt client exiting\n");
+    log_drain(SIZE_MAX);
     return 0;
 }
 
 // Inicializa o estacionamento
 void init_parking_lots()
 {
-    for (int i = 0; i < PARKING_LOT_SIZE; i++)
-    {
-        parking_lots[i].id = i + 1;                 // ID do estacionamento
-        parking_lots[i].status = 0;                 // Status do estacionamento (0 - livre)
-        parking_lots[i].reservation_start_time = 0; // Hora de início da reserva
-    }
+    parking_store_init(&parking_store); // Todas as vagas livres
+    parking_journal_init();
+
+    // Relatório de memória: bitmaps de status/mudanças + heap de prazos e seu índice (dimensionados por PARKING_MAX_RESERVATIONS)
+    size_t store_bytes = PARKING_STORE_BYTES(PARKING_LOT_SIZE);
+    size_t expiry_bytes = sizeof(reservation_expiry_entries) + sizeof(reservation_expiry_slots) + sizeof(reservation_expiry);
+    INFO_printf("Parking state: %d lots, %u bytes (store %u + reservations %u), legacy layout %u bytes\n",
+                PARKING_LOT_SIZE, (unsigned)(store_bytes + expiry_bytes), (unsigned)store_bytes, (unsigned)expiry_bytes,
+                (unsigned)(PARKING_LOT_SIZE * (16 + sizeof(int))));
 }
 
 // Atualiza o LED RGB de acordo com a quantidade de vagas livres
 void update_led_rgb()
 {
-    free_parking_lots = 0; // Reseta a quantidade de vagas livres
-
-    // Verifica a quantidade de vagas livres
-    for (int i = 0; i < PARKING_LOT_SIZE; i++)
-    {
-        if (parking_lots[i].status == 0)
-            free_parking_lots++;
-    }
+    uint16_t free_parking_lots = parking_store_count(&parking_store, PARKING_FREE); // Mantida em O(1) pelo estado
 
     // Acende uma cor no LED RGB de acordo com a quantidade de vagas livres
     if (free_parking_lots == 0)
@@ -336,155 +619,311 @@ void update_led_rgb()
         set_led_yellow();
 }
 
-// Atualiza a matriz de LEDs
-void update_led_matrix()
+// Redesenha na matriz de LEDs somente os LEDs de uma vaga (vagas além da cadeia são ignoradas)
+void draw_parking_lot(uint16_t lot)
 {
-    int parking_lot_positions[PARKING_LOT_SIZE][4] = {
-        {15, 16, 23, 24},
-        {18, 19, 20, 21},
-        {3, 4, 5, 6},
-        {0, 1, 8, 9},
+    static const int status_colors[4][3] = {
+        {0, 8, 0}, // Livre: verde
+        {8, 0, 0}, // Ocupada: vermelho
+        {4, 8, 0}, // Reservada: amarelo
+        {0, 0, 0}, // Indefinido: apagado
     };
 
-    int color[3] = {0, 0, 0};
-
-    for (int i = 0; i < PARKING_LOT_SIZE; i++)
-    {
-        color[0] = 0; // Vermelho
-        color[1] = 0; // Verde
-        color[2] = 0; // Azul
+    if (lot >= PARKING_MATRIX_LOTS)
+        return;
 
-        if (parking_lots[i].status == 0)
-            color[1] = 8; // Verde
-        else if (parking_lots[i].status == 1)
-            color[0] = 8; // Vermelho
-        else if (parking_lots[i].status == 2)
-        {
-            color[0] = 4; // Amarelo
-            color[1] = 8;
-        }
+    const int *color = status_colors[parking_store_get(&parking_store, lot)];
+    for (int j = 0; j < PARKING_LEDS_PER_LOT; j++)
+        ws2812b_draw_point(parking_lot_leds[lot][j], color);
+}
 
-        for (int j = 0; j < 4; j++)
-            ws2812b_draw_point(parking_lot_positions[i][j], color);
-    }
+// Redesenha a matriz de LEDs inteira
+void update_led_matrix()
+{
+    for (int i = 0; i < PARKING_MATRIX_LOTS; i++)
+        draw_parking_lot(i);
 
-    ws2812b_write();
+    ws2812b_commit();
 }
 
 // Atualiza o display OLED
+// Com mais vagas do que linhas, mostra a página que contém a vaga selecionada
 void update_display()
 {
+    uint16_t first = current_parking_lot - current_parking_lot % PARKING_DISPLAY_LINES;
+    char buffer[20];
+
     ssd1306_fill(&ssd, false); // Limpa a tela
     draw_centered_text(&ssd, "Estacionamento", 0);
-    ssd1306_draw_string(&ssd, "Vagas:", 0, 15);
+    if (PARKING_LOT_SIZE > PARKING_DISPLAY_LINES)
+        snprintf(buffer, sizeof(buffer), "Livres: %u", parking_store_count(&parking_store, PARKING_FREE));
+    else
+        snprintf(buffer, sizeof(buffer), "Vagas:");
+    ssd1306_draw_string(&ssd, buffer, 0, 15);
 
-    for (int i = 0; i < PARKING_LOT_SIZE; i++)
+    for (int i = 0; i < PARKING_DISPLAY_LINES && first + i < PARKING_LOT_SIZE; i++)
     {
-        const char *status_text = (parking_lots[i].status == 0) ? "Livre" : (parking_lots[i].status == 1) ? "Ocupada"
-                                                                        : (parking_lots[i].status == 2)   ? "Reservada"
-                                                                                                            : "Indefinida";
-
-        char buffer[20];
+        uint8_t status = parking_store_get(&parking_store, first + i);
+        const char *status_text = (status == PARKING_FREE) ? "Livre" : (status == PARKING_OCCUPIED) ? "Ocupada"
+                                                                   : (status == PARKING_RESERVED)   ? "Reservada"
+                                                                                                    : "Indefinida";
 
-        snprintf(buffer, sizeof(buffer), "%d: %s", i + 1, status_text);
+        snprintf(buffer, sizeof(buffer), "%d: %s", first + i + 1, status_text);
         ssd1306_draw_string(&ssd, buffer, 5, (i * 10) + 25);
     }
 
-    ssd1306_send_data(&ssd);        // Envia os dados para o display
+    display_send(); // Envia as áreas alteradas por DMA, sem bloquear
 }
 
-// Atualiza o buzzer
-void update_buzzer()
+// Envia as áreas alteradas; com uma transferência em andamento o envio fica para display_flush_worker
+static void display_send(void)
 {
-    // Verifica qual foi a mudança de status
-    for (int i = 0; i < PARKING_LOT_SIZE; i++)
+    uint32_t start_us = time_us_32();
+    if (!ssd1306_is_busy(&ssd))
+        display_send_at_us = start_us;
+    bool started = ssd1306_send_data_async(&ssd);
+    TRACE_EVENT(TRACE_DISPLAY_SEND, started, 0);
+    if (!started)
+        return;
+
+    // A reserva aparece no fim desta transferência (ou já está na tela se não havia nada a enviar).
+    // display_flush_done altera as mesmas marcações na interrupção do fim do envio
+    uint32_t irq_state = save_and_disable_interrupts();
+    bool shown = false;
+    if (reservation_pending && ssd1306_is_busy(&ssd))
+        reservation_sent = true;
+    else if (reservation_pending)
     {
-        if (parking_lots[i].status != parking_lot_status[i])
-        {
-            parking_lot_status[i] = parking_lots[i].status;
+        reservation_pending = false;
+        shown = true;
+    }
+    restore_interrupts(irq_state);
+    if (shown)
+        metric_record(METRIC_RESERVATION_TO_DISPLAY, reservation_at_us);
+}
 
-            // Toca o buzzer se a vaga estiver ocupada
-            if (parking_lots[i].status == 1)
-            {
-                play_tone(BUZZER_A_PIN, 300);
-                sleep_ms(250); // Toca o buzzer por 250ms
-                stop_tone(BUZZER_A_PIN);
-            }
-            // Toca o buzzer se a vaga estiver livre
-            else if (parking_lots[i].status == 0)
-            {
-                play_tone(BUZZER_A_PIN, 2000);
-                sleep_ms(250); // Toca o buzzer por 250ms
-                stop_tone(BUZZER_A_PIN);
-            }
-            // Toca o buzzer se a vaga estiver reservada
-            else if (parking_lots[i].status == 2)
-            {
-                play_tone(BUZZER_A_PIN, 900);
-                sleep_ms(250); // Toca o buzzer por 250ms
-                stop_tone(BUZZER_A_PIN);
-            }
-        }
+// Fim de um envio DMA do display: se houve redesenho durante a transferência, agenda um único envio extra.
+// Um envio abortado não conta nas métricas; o driver reenvia a tela inteira no próximo envio.
+static void display_flush_done(__unused void *arg, bool ok)
+{
+    TRACE_EVENT(TRACE_DISPLAY_DONE, ok, 0);
+    if (!ok)
+    {
+        ERROR_printf("display transfer aborted\n");
+        reservation_sent = false; // A reserva continua pendente até um envio completo
+    }
+    else
+        metric_record(METRIC_DISPLAY_SEND, display_send_at_us);
+
+    if (ok && reservation_sent)
+    {
+        reservation_pending = reservation_sent = false;
+        metric_record(METRIC_RESERVATION_TO_DISPLAY, reservation_at_us);
+    }
+
+    if (ssd1306_flush_pending(&ssd))
+        async_context_set_work_pending(cyw43_arch_async_context(), &display_flush_worker);
+}
+
+// Envia ao display as alterações acumuladas durante a transferência anterior
+static void display_flush_worker_fn(__unused async_context_t *context, __unused async_when_pending_worker_t *worker)
+{
+    display_send();
+}
+
+// Toca o aviso sonoro do status de uma vaga
+// Os tons são enfileirados e tocados em segundo plano, sem bloquear quem chamou
+void update_buzzer(uint16_t lot)
+{
+    static const uint status_tones[3] = {
+        2000, // Vaga livre
+        300,  // Vaga ocupada
+        900,  // Vaga reservada
+    };
+
+    uint8_t status = parking_store_get(&parking_store, lot);
+    if (status < 3)
+    {
+        TRACE_EVENT(TRACE_BUZZER_TONE, lot, status_tones[status]);
+        buzzer_enqueue(BUZZER_A_PIN, status_tones[status], BUZZER_TONE_MS, BUZZER_GAP_MS);
     }
 }
 
 // Atualiza os sinais de saída
+// Só as vagas marcadas no bitmap de mudanças são redesenhadas e anunciadas no buzzer
 void update_outputs()
 {
+    uint32_t start_us = time_us_32();
+    uint16_t lot;
+    TRACE_EVENT(TRACE_OUTPUTS_BEGIN, 0, 0);
+    while (parking_store_take_changed(&parking_store, PARKING_TRACK_OUTPUTS, &lot))
+    {
+        draw_parking_lot(lot);
+        update_buzzer(lot);
+    }
+
+    // Envia o quadro da matriz uma única vez (nada é enviado se não houve mudança)
+    uint32_t matrix_us = time_us_32();
+    if (ws2812b_commit())
+    {
+        metric_record(METRIC_LED_MATRIX_WRITE, matrix_us);
+        TRACE_EVENT(TRACE_LED_MATRIX_WRITE, 0, 0);
+    }
+
     // Atualiza o LED RGB
     update_led_rgb();
 
-    // Atualiza a matriz de LEDs
-    update_led_matrix();
-
     // Atualiza o display OLED
     update_display();
+    INFO_printf("Outputs updated: Free parking lots: %d\n", parking_store_count(&parking_store, PARKING_FREE));
+    metric_record(METRIC_UPDATE_OUTPUTS, start_us);
+    TRACE_EVENT(TRACE_OUTPUTS_END, parking_store_count(&parking_store, PARKING_FREE), 0);
+}
+
+// Altera o status de uma vaga; sem conexão com o broker a transição vai para o journal, que é
+// reenviado após a reconexão (online o custo é só o do bitmap)
+static bool set_lot_status(uint16_t lot, uint8_t status)
+{
+    if (!parking_store_set(&parking_store, lot, status))
+        return false;
 
-    // Atualiza o buzzer
-    update_buzzer();
-    INFO_printf("Outputs updated: Free parking lots: %d\n", free_parking_lots);
+    TRACE_EVENT(TRACE_LOT_STATUS, lot, status);
+    if (!broker_online)
+        parking_journal_record(lot, status, to_ms_since_boot(get_absolute_time()));
+    return true;
 }
 
 // Função de callback para os botões GPIO
+// Apenas registra o evento com o carimbo de tempo e acorda o worker; nada é processado na interrupção
 void gpio_callback_handler(uint gpio, uint32_t events)
 {
-    int now = to_ms_since_boot(get_absolute_time()); // Obtém o tempo atual em milissegundos
+    uint32_t now = time_us_32();
+    TRACE_EVENT(TRACE_GPIO_IRQ, gpio, events);
+    button_event_push(gpio, events, now);
+    async_context_set_work_pending(cyw43_arch_async_context(), &button_worker);
+    metric_record(METRIC_GPIO_IRQ, now);
+}
 
-    // Verifica se o botão A está pressionado
-    if (btn_is_pressed(BTN_A_PIN) && (now - last_a) > debounce)
-    {
-        last_a = now; // Atualiza o último tempo em que o botão A foi pressionado
+// Consome todos os eventos pendentes, em ordem; as mudanças são publicadas pela janela de agrupamento
+static void button_worker_fn(__unused async_context_t *context, __unused async_when_pending_worker_t *worker)
+{
+    bool changed = false;
+    uint16_t displayed = current_parking_lot / PARKING_DISPLAY_LINES;
+    button_event_t event;
 
-        if (current_parking_lot > 0)
-            current_parking_lot--;
-    }
-    else if (btn_is_pressed(BTN_B_PIN) && (now - last_b) > debounce)
+    while (button_event_pop(&event))
     {
-        last_b = now; // Atualiza o último tempo em que o botão B foi pressionado
+        bool accepted = button_event_accept(&event, debounce_us);
+        TRACE_EVENT(TRACE_BUTTON, event.gpio, accepted);
+        if (!accepted)
+            continue;
 
-        if (current_parking_lot < PARKING_LOT_SIZE - 1)
-            current_parking_lot++;
+        if (event.gpio == BTN_A_PIN)
+        {
+            if (current_parking_lot > 0)
+                current_parking_lot--;
+        }
+        else if (event.gpio == BTN_B_PIN)
+        {
+            if (current_parking_lot < PARKING_LOT_SIZE - 1)
+                current_parking_lot++;
+        }
+        else if (event.gpio == BTN_SW_PIN)
+        {
+            uint16_t lot = current_parking_lot;
+            uint8_t status = parking_store_get(&parking_store, lot);
+            if (status == PARKING_RESERVED)
+                cancel_reservation_expiry(lot);
+
+            if (status == PARKING_FREE || status == PARKING_RESERVED)
+                set_lot_status(lot, PARKING_OCCUPIED);
+            else if (status == PARKING_OCCUPIED)
+                set_lot_status(lot, PARKING_FREE);
+
+            // Mede até a confirmação da primeira publicação deste novo status (da vaga ou de um snapshot)
+            if (!press_pending)
+            {
+                press_at_us = event.timestamp_us;
+                press_lot = lot;
+                press_pending = true;
+                press_sent = false;
+            }
+            changed = true;
+            request_status_publish();
+            INFO_printf("Parking lot %d status: %d\n", lot + 1, parking_store_get(&parking_store, lot));
+        }
     }
-    else if (btn_is_pressed(BTN_SW_PIN) && (now - last_sw) > debounce)
-    {
-        last_sw = now;
-        if (parking_lots[current_parking_lot].status == 0 || parking_lots[current_parking_lot].status == 2)
-            parking_lots[current_parking_lot].status = 1;
-        else if (parking_lots[current_parking_lot].status == 1)
-            parking_lots[current_parking_lot].status = 0;
 
-        publish_parking_status_flag = true; // Sinaliza para publicar depois
-        INFO_printf("Parking lot %d status: %d\n", parking_lots[current_parking_lot].id, parking_lots[current_parking_lot].status);
-    }
+    // Trocar a página do display também exige redesenho
+    if (current_parking_lot / PARKING_DISPLAY_LINES != displayed)
+        changed = true;
+
+    if (changed)
+        update_outputs(); // Atualiza os LEDs, a matriz, o display e o buzzer uma única vez
 }
 
-// Requisição para publicar
-static void pub_request_cb(__unused void *arg, err_t err)
+// Rearma o worker de expiração para o prazo mais próximo (ou o desarma se não houver reservas)
+static void arm_reservation_worker()
 {
-    if (err != 0)
+    async_context_t *context = cyw43_arch_async_context();
+    absolute_time_t deadline;
+
+    async_context_remove_at_time_worker(context, &reservation_worker);
+    if (expiry_heap_peek(&reservation_expiry, &deadline))
+        async_context_add_at_time_worker_at(context, &reservation_worker, deadline);
+}
+
+// Agenda a expiração da reserva de uma vaga e rearma o worker (false se a tabela de reservas estiver cheia)
+static bool schedule_reservation_expiry(uint16_t index, absolute_time_t start, uint32_t duration_ms)
+{
+    if (!expiry_heap_schedule(&reservation_expiry, index, delayed_by_ms(start, duration_ms)))
+        return false;
+
+    arm_reservation_worker();
+    return true;
+}
+
+// Cancela a expiração de uma vaga que deixou de estar reservada
+static void cancel_reservation_expiry(uint16_t index)
+{
+    if (expiry_heap_cancel(&reservation_expiry, index))
+        arm_reservation_worker();
+}
+
+// Expira somente as reservas vencidas (custo proporcional a elas) e rearma para o próximo prazo
+static void reservation_worker_fn(__unused async_context_t *context, __unused async_at_time_worker_t *worker)
+{
+    bool expired = false;
+    uint16_t index;
+
+    while (expiry_heap_pop_expired(&reservation_expiry, get_absolute_time(), &index))
     {
-        ERROR_printf("pub_request_cb failed %d", err);
+        if (parking_store_get(&parking_store, index) != PARKING_RESERVED)
+            continue;
+
+        set_lot_status(index, PARKING_FREE);
+        TRACE_EVENT(TRACE_RESERVATION_EXPIRED, index, 0);
+        expired = true;
+        request_status_publish();
+        INFO_printf("Reserva da vaga %d expirada\n", index + 1);
     }
+
+    if (expired)
+        update_outputs();
+    arm_reservation_worker();
+}
+
+// Uma requisição MQTT terminou e liberou espaço: retoma a fila e as vagas pendentes
+static void publish_slot_freed(__unused void *arg)
+{
+    async_context_set_work_pending(cyw43_arch_async_context(), &status_publish_worker);
+}
+
+// Enfileira uma mensagem curta e tenta enviá-la; se o cliente estiver sem espaço ela sai quando uma requisição terminar
+static void publish_message(MQTT_CLIENT_DATA_T *state, uint16_t key, const char *topic, const char *msg, uint8_t qos, bool retain)
+{
+    publish_queue_push(&state->publish_queue, key, topic, msg, strlen(msg), qos, retain);
+    publish_queue_flush(&state->publish_queue);
 }
 
 // Topico MQTT
@@ -499,17 +938,336 @@ static const char *full_topic(MQTT_CLIENT_DATA_T *state, const char *name)
 #endif
 }
 
-// Publicar status do estacionamento
+// Publica o snapshot retido se o estado mudou desde o último enviado (um snapshot em andamento por vez)
+static void publish_parking_snapshot(MQTT_CLIENT_DATA_T *state)
+{
+    static uint8_t buffer[PARKING_SNAPSHOT_MAX_BYTES(PARKING_LOT_SIZE)];
+
+    if (snapshot_in_flight || (snapshot_valid && snapshot_version == parking_store.version))
+        return;
+
+    size_t len = parking_snapshot_encode(&parking_store, snapshot_sequence + 1, buffer, sizeof(buffer));
+    err_t err = mqtt_publish(state->mqtt_client_inst, full_topic(state, "/parking/snapshot"), buffer, len, MQTT_PUBLISH_QOS,
+                             MQTT_SNAPSHOT_RETAIN, snapshot_pub_request_cb, state);
+    if (err == ERR_OK)
+    {
+        publish_stats.messages++;
+        snapshot_sequence++;
+        snapshot_version = parking_store.version;
+        snapshot_valid = true;
+        snapshot_in_flight = true;
+        snapshot_press = press_pending && !press_sent;
+        press_sent |= snapshot_press;
+    }
+}
+
+// Confirmação da publicação do snapshot; se falhou ou o estado mudou nesse meio tempo, envia outro
+static void snapshot_pub_request_cb(__unused void *arg, err_t err)
+{
+    bool press = snapshot_press;
+    snapshot_in_flight = false;
+    snapshot_press = false;
+    if (err != 0)
+    {
+        ERROR_printf("snapshot publish failed %d\n", err);
+        snapshot_valid = false;
+        if (press)
+            press_sent = false;
+    }
+    else
+        press_acked(press);
+
+    publish_slot_freed(arg);
+}
+
+// Reenvia as transições registradas offline, em ordem, um lote por mensagem e um lote por vez.
+// Payload: agora em ms (4 bytes), quantidade (2 bytes) e, por transição, ms (4), vaga (2) e status (1), em big-endian
+static void publish_journal(MQTT_CLIENT_DATA_T *state)
+{
+    static journal_entry_t entries[PARKING_JOURNAL_BATCH];
+    static uint8_t buffer[6 + PARKING_JOURNAL_BATCH * 7];
+
+    if (journal_in_flight || parking_journal_count() == 0)
+        return;
+
+    uint16_t count = parking_journal_peek(entries, PARKING_JOURNAL_BATCH);
+    uint32_t now = to_ms_since_boot(get_absolute_time());
+    uint8_t *p = buffer;
+
+    *p++ = now >> 24;
+    *p++ = now >> 16;
+    *p++ = now >> 8;
+    *p++ = now;
+    *p++ = count >> 8;
+    *p++ = count;
+    for (uint16_t i = 0; i < count; i++)
+    {
+        uint16_t id = entries[i].lot + 1;
+        *p++ = entries[i].timestamp_ms >> 24;
+        *p++ = entries[i].timestamp_ms >> 16;
+        *p++ = entries[i].timestamp_ms >> 8;
+        *p++ = entries[i].timestamp_ms;
+        *p++ = id >> 8;
+        *p++ = id;
+        *p++ = entries[i].status;
+    }
+
+    if (mqtt_publish(state->mqtt_client_inst, full_topic(state, "/parking/journal"), buffer, p - buffer, MQTT_PUBLISH_QOS,
+                     MQTT_PUBLISH_RETAIN, journal_pub_request_cb, state) == ERR_OK)
+    {
+        journal_in_flight = true;
+        publish_stats.messages++;
+    }
+}
+
+// Lote confirmado pelo broker: só então as transições saem do journal; se falhou, o mesmo lote é reenviado
+static void journal_pub_request_cb(void *arg, err_t err)
+{
+    journal_in_flight = false;
+    if (err == 0)
+        parking_journal_commit();
+    else
+        ERROR_printf("journal publish failed %d\n", err);
+
+    publish_slot_freed(arg);
+}
+
+// Os histogramas recebem valores das interrupções (display) e do contexto assíncrono: a gravação é feita
+// com as interrupções desligadas, como em trace_record
+static inline void metric_record(metric_id_t id, uint32_t start_us)
+{
+#if PARKING_METRICS
+    uint32_t elapsed_us = time_us_32() - start_us;
+    uint32_t irq_state = save_and_disable_interrupts();
+    latency_histogram_record(&metrics[id], elapsed_us);
+    restore_interrupts(irq_state);
+#endif
+}
+
+static void press_acked(bool carrier)
+{
+    if (!carrier || !press_pending)
+        return;
+    press_pending = false;
+    metric_record(METRIC_PRESS_TO_ACK, press_at_us);
+}
+
+// Publica os histogramas acumulados desde o boot (uma mensagem por vez, QoS 0).
+// Payload: formato (1 byte), agora em ms (4 bytes), quantidade de histogramas (1 byte) e cada histograma
+// no formato de latency_histogram.h; os leitores calculam as diferenças entre duas publicações
+static void publish_metrics(MQTT_CLIENT_DATA_T *state)
+{
+#if PARKING_METRICS
+    static uint8_t buffer[6 + METRIC_COUNT * LATENCY_HISTOGRAM_MAX_BYTES];
+
+    if (metrics_in_flight)
+        return;
+
+    uint32_t now = to_ms_since_boot(get_absolute_time());
+    uint8_t *p = buffer;
+    *p++ = PARKING_METRICS_FORMAT;
+    *p++ = now >> 24;
+    *p++ = now >> 16;
+    *p++ = now >> 8;
+    *p++ = now;
+    *p++ = METRIC_COUNT;
+    for (uint8_t id = 0; id < METRIC_COUNT; id++)
+    {
+        // Cópia consistente (a soma tem 64 bits) antes de codificar fora da seção crítica
+        uint32_t irq_state = save_and_disable_interrupts();
+        latency_histogram_t histogram = metrics[id];
+        restore_interrupts(irq_state);
+        p += latency_histogram_encode(&histogram, id, p);
+    }
+
+    if (mqtt_publish(state->mqtt_client_inst, full_topic(state, "/metrics"), buffer, p - buffer, MQTT_HEARTBEAT_QOS,
+                     MQTT_PUBLISH_RETAIN, metrics_pub_request_cb, state) == ERR_OK)
+        metrics_in_flight = true;
+#endif
+}
+
+// Publicação periódica dos histogramas (nada é enviado enquanto desconectado)
+static void metrics_worker_fn(async_context_t *context, async_at_time_worker_t *worker)
+{
+    MQTT_CLIENT_DATA_T *state = (MQTT_CLIENT_DATA_T *)worker->user_data;
+    if (state->connect_done && mqtt_client_is_connected(state->mqtt_client_inst))
+        publish_metrics(state);
+    async_context_add_at_time_worker_in_ms(context, worker, PARKING_METRICS_INTERVAL_S * 1000);
+}
+
+static void metrics_pub_request_cb(void *arg, err_t err)
+{
+    metrics_in_flight = false;
+    if (err != 0)
+        ERROR_printf("metrics publish failed %d\n", err);
+
+    publish_slot_freed(arg);
+}
+
+// Dump do trace em /trace, em partes de TRACE_DUMP_CHUNK_EVENTS eventos (formato em lib/trace/trace.h).
+// O registro fica pausado até a última parte ser confirmada, para o conteúdo não mudar no meio
+static void publish_trace_dump(MQTT_CLIENT_DATA_T *state)
+{
+    static uint8_t buffer[TRACE_DUMP_HEADER + TRACE_DUMP_CHUNK_EVENTS * TRACE_EVENT_BYTES];
+
+    if (!trace_dump_active || trace_dump_in_flight)
+        return;
+
+    size_t len = trace_encode(trace_dump_offset, TRACE_DUMP_CHUNK_EVENTS, buffer, sizeof(buffer));
+    if (mqtt_publish(state->mqtt_client_inst, full_topic(state, "/trace"), buffer, len, MQTT_PUBLISH_QOS,
+                     MQTT_PUBLISH_RETAIN, trace_pub_request_cb, state) == ERR_OK)
+    {
+        trace_dump_in_flight = true;
+        trace_dump_last = (len - TRACE_DUMP_HEADER) / TRACE_EVENT_BYTES;
+        trace_dump_offset += trace_dump_last;
+    }
+}
+
+// Parte confirmada: a próxima sai pelo worker de publicação; se falhou, a mesma parte é reenviada
+static void trace_pub_request_cb(void *arg, err_t err)
+{
+    trace_dump_in_flight = false;
+    if (err != 0)
+    {
+        ERROR_printf("trace publish failed %d\n", err);
+        trace_dump_offset -= trace_dump_last;
+    }
+    else if (trace_dump_offset >= trace_count())
+    {
+        trace_dump_active = false;
+        trace_pause(false);
+    }
+
+    publish_slot_freed(arg);
+}
+
+// Força a republicação de todas as vagas e do snapshot
+static void request_full_resync(void)
+{
+    parking_store_mark_all_changed(&parking_store, PARKING_TRACK_PUBLISH);
+    snapshot_valid = false;
+}
+
+// Publicar status das vagas alteradas desde a última publicação confirmada
+// Cada vaga só sai do bitmap de publicação ao ser enviada; se o envio falhar ela volta a ser marcada
 static void publish_parking_status(MQTT_CLIENT_DATA_T *state)
 {
     char topic[MQTT_TOPIC_LEN];
     char msg[32];
-    for (int i = 0; i < PARKING_LOT_SIZE; i++)
+    uint16_t lot;
+
+    // Desconectado: as mudanças continuam marcadas e a conexão força uma ressincronização completa
+    if (!state->connect_done || !mqtt_client_is_connected(state->mqtt_client_inst))
+        return;
+
+    uint32_t start_us = time_us_32();
+    uint32_t messages = publish_stats.messages;
+    TRACE_EVENT(TRACE_PUBLISH_BEGIN, 0, 0);
+
+    // Mensagens que esperavam espaço, o histórico offline e o dump do trace saem antes
+    publish_queue_flush(&state->publish_queue);
+    publish_journal(state);
+    publish_trace_dump(state);
+    publish_batch_replies(state);
+
+    if (PARKING_PUBLISH_MODE & PARKING_PUBLISH_SNAPSHOT)
+        publish_parking_snapshot(state);
+
+    while ((PARKING_PUBLISH_MODE & PARKING_PUBLISH_PER_LOT) &&
+           parking_store_take_changed(&parking_store, PARKING_TRACK_PUBLISH, &lot))
+    {
+        snprintf(topic, sizeof(topic), "%s%d", full_topic(state, "/parking/status/"), lot + 1);
+        snprintf(msg, sizeof(msg), "%d", parking_store_get(&parking_store, lot));
+        err_t err = mqtt_publish(state->mqtt_client_inst, topic, msg, strlen(msg), MQTT_PUBLISH_QOS, MQTT_PUBLISH_RETAIN,
+                                 status_pub_request_cb, (void *)(uintptr_t)lot);
+        if (err != ERR_OK)
+        {
+            // Sem espaço para mais requisições: retoma quando uma confirmação chegar (ou no próximo heartbeat)
+            parking_store_mark_changed(&parking_store, PARKING_TRACK_PUBLISH, lot);
+            break;
+        }
+        publish_stats.messages++;
+
+        // Confirmações chegam na ordem de envio; a publicação da vaga do último toque é marcada
+        if (status_sent_count < count_of(status_sent_at_us))
+        {
+            uint8_t slot = (status_sent_head + status_sent_count++) % count_of(status_sent_at_us);
+            status_sent_at_us[slot] = time_us_32();
+            status_sent_press[slot] = press_pending && !press_sent && lot == press_lot;
+            press_sent |= status_sent_press[slot];
+        }
+    }
+
+    metric_record(METRIC_PUBLISH_STATUS, start_us);
+    TRACE_EVENT(TRACE_PUBLISH_END, publish_stats.messages - messages, 0);
+}
+
+// Registra uma mudança de status; a publicação sai ao fim da janela de agrupamento
+static void request_status_publish(void)
+{
+    async_context_t *context = cyw43_arch_async_context();
+    absolute_time_t now = get_absolute_time();
+
+    publish_stats.events++;
+    if (!coalesce_armed)
+    {
+        coalesce_armed = true;
+        coalesce_deadline = delayed_by_ms(now, PUBLISH_COALESCE_MAX_MS);
+    }
+
+    // Reinicia a janela, respeitando o limite de latência
+    absolute_time_t at = delayed_by_ms(now, PUBLISH_COALESCE_MS);
+    if (absolute_time_diff_us(coalesce_deadline, at) > 0)
+        at = coalesce_deadline;
+
+    async_context_remove_at_time_worker(context, &publish_coalesce_worker);
+    async_context_add_at_time_worker_at(context, &publish_coalesce_worker, at);
+}
+
+// Fim da janela: publica de uma vez todas as mudanças acumuladas
+static void publish_coalesce_worker_fn(__unused async_context_t *context, async_at_time_worker_t *worker)
+{
+    coalesce_armed = false;
+    publish_stats.flushes++;
+    TRACE_EVENT(TRACE_COALESCE_FLUSH, 0, 0);
+    publish_parking_status((MQTT_CLIENT_DATA_T *)worker->user_data);
+}
+
+// Confirmação da publicação do status de uma vaga (arg é o índice da vaga)
+static void status_pub_request_cb(void *arg, err_t err)
+{
+    uint16_t lot = (uint16_t)(uintptr_t)arg;
+    TRACE_EVENT(TRACE_PUBLISH_ACK, lot, err);
+    bool timed = status_sent_count > 0;
+    uint32_t sent_at_us = status_sent_at_us[status_sent_head];
+    bool press = timed && status_sent_press[status_sent_head];
+    if (timed)
+    {
+        status_sent_head = (status_sent_head + 1) % count_of(status_sent_at_us);
+        status_sent_count--;
+    }
+
+    if (err != 0)
     {
-        snprintf(topic, sizeof(topic), "%s%d", full_topic(state, "/parking/status/"), parking_lots[i].id);
-        snprintf(msg, sizeof(msg), "%d", parking_lots[i].status);
-        mqtt_publish(state->mqtt_client_inst, topic, msg, strlen(msg), MQTT_PUBLISH_QOS, MQTT_PUBLISH_RETAIN, pub_request_cb, state);
+        ERROR_printf("status publish of lot %d failed %d\n", lot + 1, err);
+        parking_store_mark_changed(&parking_store, PARKING_TRACK_PUBLISH, lot);
+        if (press)
+            press_sent = false; // O reenvio da vaga leva o toque
     }
+    else
+    {
+        if (timed)
+            metric_record(METRIC_PUBLISH_RTT, sent_at_us);
+        press_acked(press);
+    }
+
+    publish_slot_freed(arg);
+}
+
+// Continua a publicação da fila e das vagas pendentes
+static void status_publish_worker_fn(__unused async_context_t *context, async_when_pending_worker_t *worker)
+{
+    publish_parking_status((MQTT_CLIENT_DATA_T *)worker->user_data);
 }
 
 // Requisição de Assinatura - subscribe
@@ -518,7 +1276,8 @@ static void sub_request_cb(void *arg, err_t err)
     MQTT_CLIENT_DATA_T *state = (MQTT_CLIENT_DATA_T *)arg;
     if (err != 0)
     {
-        panic("subscribe request failed %d", err);
+        ERROR_printf("subscribe request failed %d\n", err);
+        return;
     }
     state->subscribe_count++;
 }
@@ -529,7 +1288,7 @@ static void unsub_request_cb(void *arg, err_t err)
     MQTT_CLIENT_DATA_T *state = (MQTT_CLIENT_DATA_T *)arg;
     if (err != 0)
     {
-        panic("unsubscribe request failed %d", err);
+        ERROR_printf("unsubscribe request failed %d\n", err);
     }
     state->subscribe_count--;
     assert(state->subscribe_count >= 0);
@@ -545,119 +1304,382 @@ static void unsub_request_cb(void *arg, err_t err)
 static void sub_unsub_topics(MQTT_CLIENT_DATA_T *state, bool sub)
 {
     mqtt_request_cb_t cb = sub ? sub_request_cb : unsub_request_cb;
-    mqtt_sub_unsub(state->mqtt_client_inst, full_topic(state, "/print"), MQTT_SUBSCRIBE_QOS, cb, state, sub);
-    mqtt_sub_unsub(state->mqtt_client_inst, full_topic(state, "/ping"), MQTT_SUBSCRIBE_QOS, cb, state, sub);
-    mqtt_sub_unsub(state->mqtt_client_inst, full_topic(state, "/exit"), MQTT_SUBSCRIBE_QOS, cb, state, sub);
-    mqtt_sub_unsub(state->mqtt_client_inst, full_topic(state, "/parking/+/reservation"), MQTT_SUBSCRIBE_QOS, cb, state, sub);
+    for (int i = 0; i < count_of(topic_routes); i++)
+        mqtt_sub_unsub(state->mqtt_client_inst, full_topic(state, topic_routes[i].pattern), MQTT_SUBSCRIBE_QOS, cb, state, sub);
 }
 
 // Dados de entrada MQTT
+// O tópico já foi resolvido em mqtt_incoming_publish_cb: só chama o tratador da rota
 static void mqtt_incoming_data_cb(void *arg, const u8_t *data, u16_t len, u8_t flags)
 {
     MQTT_CLIENT_DATA_T *state = (MQTT_CLIENT_DATA_T *)arg;
-#if MQTT_UNIQUE_TOPIC
-    const char *basic_topic = state->topic + strlen(state->mqtt_client_info.client_id) + 1;
-#else
-    const char *basic_topic = state->topic;
-#endif
-    strncpy(state->data, (const char *)data, len);
-    state->len = len;
-    state->data[len] = '\0';
+    if (!state->route)
+        return;
 
-    DEBUG_printf("Topic: %s, Message: %s\n", state->topic, state->data);
+    const uint8_t *payload;
+    uint32_t payload_len;
+    switch (payload_assembler_feed(&state->payload, data, len, &flags, &payload, &payload_len))
+    {
+    case PAYLOAD_CHUNK:
+    case PAYLOAD_COMPLETE:
+        DEBUG_printf("Message: %.*s\n", (int)payload_len, payload);
+        state->route->handler(state, state->route_params, payload, payload_len, flags);
+        break;
+    case PAYLOAD_REJECTED:
+        ERROR_printf("Payload of %lu bytes rejected on %s (max %lu)\n", (unsigned long)state->payload.expected,
+                     state->route->pattern, (unsigned long)state->route->max_len);
+        break;
+    default:
+        break;
+    }
+}
+
+// Imprime a mensagem recebida
+static void handle_print(__unused void *arg, __unused const int32_t *params, const uint8_t *data, uint16_t len, __unused uint8_t flags)
+{
+    INFO_printf("%.*s\n", len, data);
+}
 
-    if (strcmp(basic_topic, "/print") == 0)
+// Responde com o tempo ligado
+static void handle_ping(void *arg, __unused const int32_t *params, __unused const uint8_t *data, __unused uint16_t len, __unused uint8_t flags)
+{
+    MQTT_CLIENT_DATA_T *state = (MQTT_CLIENT_DATA_T *)arg;
+    char buf[11];
+    snprintf(buf, sizeof(buf), "%u", to_ms_since_boot(get_absolute_time()) / 1000);
+    publish_message(state, PUBLISH_KEY_UPTIME, full_topic(state, "/uptime"), buf, MQTT_PUBLISH_QOS, MQTT_PUBLISH_RETAIN);
+}
+
+// Encerra o cliente depois de cancelar as assinaturas
+static void handle_exit(void *arg, __unused const int32_t *params, __unused const uint8_t *data, __unused uint16_t len, __unused uint8_t flags)
+{
+    MQTT_CLIENT_DATA_T *state = (MQTT_CLIENT_DATA_T *)arg;
+    state->stop_client = true;      // stop the client when ALL subscriptions are stopped
+    sub_unsub_topics(state, false); // unsubscribe
+}
+
+// Pede o dump do trace; as partes são enviadas uma por vez pelo worker de publicação
+static void handle_trace_dump(__unused void *arg, __unused const int32_t *params, __unused const uint8_t *data, __unused uint16_t len, __unused uint8_t flags)
+{
+    if (trace_dump_active)
+        return;
+
+    trace_pause(true);
+    trace_dump_active = true;
+    trace_dump_offset = 0;
+    INFO_printf("Trace dump: %u events, %lu overwritten\n", trace_count(), (unsigned long)trace_overwritten());
+    async_context_set_work_pending(cyw43_arch_async_context(), &status_publish_worker);
+}
+
+// Reserva de uma vaga: params[0] é o id do tópico /parking/<id>/reservation
+static void handle_reservation(__unused void *arg, const int32_t *params, __unused const uint8_t *data, __unused uint16_t len, __unused uint8_t flags)
+{
+    int id = params[0];
+    if (id >= 1 && id <= PARKING_LOT_SIZE)
+    {
+        int index = id - 1;
+        if (parking_store_get(&parking_store, index) != PARKING_FREE)
+        {
+            INFO_printf("Vaga %d já está ocupada\n", id);
+        }
+        else if (!schedule_reservation_expiry(index, get_absolute_time(), RESERVATION_TIMEOUT_MS))
+        {
+            INFO_printf("Limite de reservas atingido, vaga %d não reservada\n", id);
+        }
+        else
+        {
+            set_lot_status(index, PARKING_RESERVED);
+            reservation_applied();
+            update_outputs(); // Atualiza os LEDs e a matriz de LEDs
+            INFO_printf("Reserva recebida para vaga %d\n", id);
+
+            // Publica o novo status ao fim da janela de agrupamento
+            request_status_publish();
+        }
+    }
+    else
     {
-        INFO_printf("%.*s\n", len, data);
+        INFO_printf("ID de vaga inválido: %d\n", id);
     }
-    else if (strcmp(basic_topic, "/ping") == 0)
+}
+
+// Reserva aplicada: mede da chegada da mensagem até o display mostrá-la (a mais antiga pendente vale)
+static void reservation_applied(void)
+{
+    uint32_t irq_state = save_and_disable_interrupts();
+    if (!reservation_pending)
     {
-        char buf[11];
-        snprintf(buf, sizeof(buf), "%u", to_ms_since_boot(get_absolute_time()) / 1000);
-        mqtt_publish(state->mqtt_client_inst, full_topic(state, "/uptime"), buf, strlen(buf), MQTT_PUBLISH_QOS, MQTT_PUBLISH_RETAIN, pub_request_cb, state);
+        reservation_at_us = message_at_us;
+        reservation_sent = false;
+        reservation_pending = true;
     }
-    else if (strcmp(basic_topic, "/exit") == 0)
+    restore_interrupts(irq_state);
+}
+
+// Aplica um item do lote; a saída e a publicação ficam para o fim do lote
+static parking_batch_result_t apply_batch_item(const parking_batch_item_t *item, absolute_time_t now)
+{
+    if (item->lot < 1 || item->lot > PARKING_LOT_SIZE)
+        return PARKING_BATCH_INVALID_LOT;
+
+    uint16_t index = item->lot - 1;
+    uint8_t status = parking_store_get(&parking_store, index);
+    if (item->duration_s == 0)
     {
-        state->stop_client = true;      // stop the client when ALL subscriptions are stopped
-        sub_unsub_topics(state, false); // unsubscribe
+        if (status != PARKING_RESERVED)
+            return PARKING_BATCH_NOT_RESERVED;
+        cancel_reservation_expiry(index);
+        set_lot_status(index, PARKING_FREE);
+        return PARKING_BATCH_APPLIED;
     }
-    else if (strncmp(basic_topic, "/parking/", 9) == 0)
+
+    // Reservar de novo uma vaga reservada só estende o prazo
+    if (status != PARKING_FREE && status != PARKING_RESERVED)
+        return PARKING_BATCH_NOT_FREE;
+    if (!schedule_reservation_expiry(index, now, item->duration_s * 1000u))
+        return PARKING_BATCH_NO_CAPACITY;
+    set_lot_status(index, PARKING_RESERVED);
+    return PARKING_BATCH_APPLIED;
+}
+
+// Reserva/liberação de várias vagas em uma mensagem (formato em parking_batch.h).
+// O comando chega em fragmentos e é decodificado conforme chega; no último fragmento o lote é aplicado
+// inteiro, com um único redesenho e uma única publicação, e o resultado de cada item vai para /parking/batch/result
+static void handle_batch(void *arg, __unused const int32_t *params, const uint8_t *data, uint16_t len, uint8_t flags)
+{
+    MQTT_CLIENT_DATA_T *state = (MQTT_CLIENT_DATA_T *)arg;
+    static uint8_t results[PARKING_BATCH_MAX_ITEMS];
+
+    if (flags & PAYLOAD_FLAG_FIRST)
+        parking_batch_begin(&batch);
+    parking_batch_feed(&batch, data, len);
+    if (!(flags & PAYLOAD_FLAG_LAST))
+        return;
+
+    uint16_t applied = 0;
+    if (parking_batch_end(&batch) == PARKING_BATCH_OK)
     {
-        int id;
-        if (sscanf(basic_topic, "/parking/%d/reservation", &id) == 1)
+        absolute_time_t now = get_absolute_time();
+        for (uint16_t i = 0; i < batch.count; i++)
         {
-            if (id >= 1 && id <= PARKING_LOT_SIZE)
-            {
-                int index = id - 1;
-                if (parking_lots[index].status == 0)
-                {
-                    parking_lots[index].status = 2; // 2 = reservado
-                    parking_lots[index].reservation_start_time = get_absolute_time();
-                    update_outputs(); // Atualiza os LEDs e a matriz de LEDs
-                    INFO_printf("Reserva recebida para vaga %d\n", id);
-
-                   // Publique imediatamente o novo status
-                    publish_parking_status(state);
-                }
-                else
-                {
-                    INFO_printf("Vaga %d já está ocupada\n", id);
-                }
-            }
-            else
-            {
-                INFO_printf("ID de vaga inválido: %d\n", id);
-            }
+            results[i] = apply_batch_item(&batch.items[i], now);
+            applied += results[i] == PARKING_BATCH_APPLIED;
         }
     }
+    INFO_printf("Batch %u: status %d, %u/%u items applied\n", batch.sequence, batch.status, applied, batch.count);
 
+    if (applied)
+    {
+        reservation_applied();
+        update_outputs();
+        request_status_publish();
+    }
 
+    // A resposta espera na fila se o cliente estiver sem espaço e sai pelo mesmo caminho das publicações de status
+    if (batch_reply_count == BATCH_REPLY_QUEUE)
+    {
+        batch_replies_dropped++;
+        ERROR_printf("Batch %u reply dropped: %u replies waiting\n", batch.sequence, batch_reply_count);
+        return;
+    }
+    uint8_t slot = (batch_reply_head + batch_reply_count++) % BATCH_REPLY_QUEUE;
+    batch_reply_len[slot] = parking_batch_reply(&batch, results, batch_replies[slot], sizeof(batch_replies[slot]));
+    publish_batch_replies(state);
+}
+
+// Envia as respostas de lote guardadas, em ordem, até o cliente recusar
+static void publish_batch_replies(MQTT_CLIENT_DATA_T *state)
+{
+    if (!state->connect_done || !mqtt_client_is_connected(state->mqtt_client_inst))
+        return;
+
+    while (batch_reply_count > 0)
+    {
+        err_t err = mqtt_publish(state->mqtt_client_inst, full_topic(state, "/parking/batch/result"),
+                                 batch_replies[batch_reply_head], batch_reply_len[batch_reply_head], MQTT_PUBLISH_QOS,
+                                 false, batch_reply_pub_request_cb, state);
+        if (err != ERR_OK)
+            return; // Tenta de novo quando uma requisição terminar (publish_slot_freed)
+        batch_reply_head = (batch_reply_head + 1) % BATCH_REPLY_QUEUE;
+        batch_reply_count--;
+    }
+}
+
+// Confirmação da resposta de um comando em lote
+static void batch_reply_pub_request_cb(void *arg, err_t err)
+{
+    if (err != 0)
+        ERROR_printf("batch reply publish failed %d\n", err);
+
+    publish_slot_freed(arg);
 }
 
 // Dados de entrada publicados
+// Resolve a rota uma única vez por mensagem, percorrendo o tópico sem cópias
 static void mqtt_incoming_publish_cb(void *arg, const char *topic, u32_t tot_len)
 {
     MQTT_CLIENT_DATA_T *state = (MQTT_CLIENT_DATA_T *)arg;
-    strncpy(state->topic, topic, sizeof(state->topic));
+    message_at_us = time_us_32();
+    state->route = topic_router_match(&topic_router, topic + state->topic_prefix_len, state->route_params);
+    TRACE_EVENT(TRACE_MQTT_MESSAGE, state->route ? state->route - topic_routes : 0xFFFF, tot_len);
+    if (!state->route)
+    {
+        DEBUG_printf("Unrouted topic %s\n", topic);
+        return;
+    }
+    // O buffer do tópico só vale neste callback: o tópico recebido é registrado aqui
+    DEBUG_printf("Topic: %s, %lu bytes\n", topic, (unsigned long)tot_len);
+    payload_assembler_begin(&state->payload, tot_len, state->route->max_len, state->route->stream);
 }
 
-// Publicar status do estacionamento
+// Heartbeat periódico: publica só a quantidade de vagas livres e reenvia o que ficou pendente;
+// a cada PARKING_RESYNC_S todas as vagas são republicadas
 static void parking_status_worker_fn(async_context_t *context, async_at_time_worker_t *worker)
 {
     MQTT_CLIENT_DATA_T *state = (MQTT_CLIENT_DATA_T *)worker->user_data;
+    static uint32_t heartbeats = 0;
+
+    if (PARKING_RESYNC_S > 0 && ++heartbeats >= PARKING_RESYNC_S / TEMP_WORKER_TIME_S)
+    {
+        heartbeats = 0;
+        request_full_resync();
+    }
+
+    const publish_queue_stats_t *queue = &state->publish_queue.stats;
+    INFO_printf("Publish stats: %lu events, %lu windows, %lu messages\n", (unsigned long)publish_stats.events,
+                (unsigned long)publish_stats.flushes, (unsigned long)publish_stats.messages);
+    INFO_printf("Publish queue: depth %u (max %u), %u lots pending, %lu dropped, %lu collapsed, %lu retries, %lu failed\n",
+                publish_queue_depth(&state->publish_queue), queue->max_depth,
+                parking_store_pending(&parking_store, PARKING_TRACK_PUBLISH), (unsigned long)queue->dropped,
+                (unsigned long)queue->collapsed, (unsigned long)queue->retries, (unsigned long)queue->failed);
+    const parking_journal_stats_t *journal = parking_journal_stats();
+    INFO_printf("Journal: %lu pending, %lu recorded, %lu replayed, %lu spilled, %lu dropped\n",
+                (unsigned long)parking_journal_count(), (unsigned long)journal->recorded, (unsigned long)journal->replayed,
+                (unsigned long)journal->spilled, (unsigned long)journal->dropped);
+    INFO_printf("Batch replies: %u pending, %lu dropped\n", batch_reply_count, (unsigned long)batch_replies_dropped);
+
+    TRACE_EVENT(TRACE_HEARTBEAT, parking_store_count(&parking_store, PARKING_FREE), 0);
+    if (state->connect_done && mqtt_client_is_connected(state->mqtt_client_inst))
+    {
+        char buf[8];
+        snprintf(buf, sizeof(buf), "%u", parking_store_count(&parking_store, PARKING_FREE));
+        publish_message(state, PUBLISH_KEY_FREE, full_topic(state, "/parking/free"), buf, MQTT_HEARTBEAT_QOS, MQTT_PUBLISH_RETAIN);
+    }
     publish_parking_status(state);
     async_context_add_at_time_worker_in_ms(context, worker, TEMP_WORKER_TIME_S * 1000);
 }
 
 // Conexão MQTT
+// Uma queda nunca derruba o controlador: agenda a reconexão e o estado local segue funcionando
 static void mqtt_connection_cb(mqtt_client_t *client, void *arg, mqtt_connection_status_t status)
 {
     MQTT_CLIENT_DATA_T *state = (MQTT_CLIENT_DATA_T *)arg;
+    TRACE_EVENT(TRACE_MQTT_CONNECTION, 0, status);
     if (status == MQTT_CONNECT_ACCEPTED)
     {
         state->connect_done = true;
+        state->mqtt_state = MQTT_STATE_CONNECTED;
+        state->connect_ms = absolute_time_diff_us(state->connect_started, get_absolute_time()) / 1000;
+        INFO_printf("MQTT connected in %lu ms%s\n", (unsigned long)state->connect_ms,
+                    state->tls_resume_offered ? " (TLS session resumption offered)" : "");
+#if LWIP_ALTCP && LWIP_ALTCP_TLS
+        // Guarda a sessão (ID ou ticket) para a próxima reconexão
+        tls_session_valid = tls_session && altcp_tls_get_session(state->mqtt_client_inst->conn, tls_session) == ERR_OK;
+#endif
+        state->backoff_ms = MQTT_RECONNECT_MIN_MS;
+        state->subscribe_count = 0;
         sub_unsub_topics(state, true); // subscribe;
 
         // indicate online
         if (state->mqtt_client_info.will_topic)
         {
-            mqtt_publish(state->mqtt_client_inst, state->mqtt_client_info.will_topic, "1", 1, MQTT_WILL_QOS, true, pub_request_cb, state);
+            publish_message(state, PUBLISH_KEY_ONLINE, state->mqtt_client_info.will_topic, "1", MQTT_WILL_QOS, true);
         }
 
-        // Publish parking status every 10 sec
-        parking_status_worker.user_data = state;
-        async_context_add_at_time_worker_in_ms(cyw43_arch_async_context(), &parking_status_worker, 0);
-    }
-    else if (status == MQTT_CONNECT_DISCONNECTED)
-    {
-        if (!state->connect_done)
+        // Tempo até a recuperação: da queda até a nova conexão aceita
+        if (!is_nil_time(state->disconnected_at))
         {
-            panic("Failed to connect to mqtt server");
+            char buf[12];
+            state->recover_ms = absolute_time_diff_us(state->disconnected_at, get_absolute_time()) / 1000;
+            state->max_recover_ms = MAX(state->max_recover_ms, state->recover_ms);
+            state->reconnects++;
+            state->disconnected_at = nil_time;
+            INFO_printf("MQTT recovered in %lu ms (reconnect %lu)\n", (unsigned long)state->recover_ms, (unsigned long)state->reconnects);
+
+            snprintf(buf, sizeof(buf), "%lu", (unsigned long)state->recover_ms);
+            publish_message(state, PUBLISH_KEY_RECOVERY, full_topic(state, "/recovery_ms"), buf, MQTT_PUBLISH_QOS, true);
         }
+
+        // Estado completo na conexão; depois só as mudanças, com heartbeat a cada 10 s.
+        // Requisições pendentes da conexão anterior foram descartadas pelo cliente
+        snapshot_in_flight = false;
+        journal_in_flight = false;
+        metrics_in_flight = false;
+        status_sent_count = 0;
+        snapshot_press = press_sent = false; // O toque pendente vai com a ressincronização
+        trace_dump_in_flight = false;
+        trace_dump_offset = 0; // Um dump interrompido recomeça do início
+        broker_online = true;
+        request_full_resync();
+        publish_parking_status(state);
     }
     else
     {
-        panic("Unexpected status");
+        ERROR_printf("MQTT connection lost (status %d)\n", status);
+        broker_online = false;
+#if LWIP_ALTCP && LWIP_ALTCP_TLS
+        // Falhou antes de ser aceita: não insiste na mesma sessão, a próxima tentativa faz o handshake completo
+        if (state->mqtt_state == MQTT_STATE_CONNECTING)
+            tls_session_valid = false;
+#endif
+        schedule_reconnect(state);
+    }
+}
+
+// Agenda a próxima tentativa: espera aleatória entre metade e o total do intervalo atual, que dobra a cada falha
+static void schedule_reconnect(MQTT_CLIENT_DATA_T *state)
+{
+    if (state->stop_client)
+        return;
+
+    if (is_nil_time(state->disconnected_at))
+        state->disconnected_at = get_absolute_time();
+
+    uint32_t delay_ms = state->backoff_ms / 2 + get_rand_32() % (state->backoff_ms / 2 + 1);
+    state->backoff_ms = MIN(state->backoff_ms * 2, MQTT_RECONNECT_MAX_MS);
+    state->mqtt_state = MQTT_STATE_BACKOFF;
+    INFO_printf("MQTT reconnect in %lu ms\n", (unsigned long)delay_ms);
+
+    async_context_remove_at_time_worker(cyw43_arch_async_context(), &reconnect_worker);
+    async_context_add_at_time_worker_in_ms(cyw43_arch_async_context(), &reconnect_worker, delay_ms);
+}
+
+// Tentativa de conexão: garante o Wi-Fi, resolve o DNS de novo (o broker pode ter mudado de endereço) e conecta
+static void reconnect_worker_fn(__unused async_context_t *context, async_at_time_worker_t *worker)
+{
+    MQTT_CLIENT_DATA_T *state = (MQTT_CLIENT_DATA_T *)worker->user_data;
+    if (state->stop_client)
+        return;
+
+    int link = cyw43_tcpip_link_status(&cyw43_state, CYW43_ITF_STA);
+    if (link != CYW43_LINK_UP)
+    {
+        // Associação ou DHCP em andamento: só espera; caso contrário pede uma nova associação
+        if (link != CYW43_LINK_JOIN && link != CYW43_LINK_NOIP)
+            cyw43_arch_wifi_connect_async(WIFI_SSID, WIFI_PASSWORD, CYW43_AUTH_WPA2_AES_PSK);
+        schedule_reconnect(state);
+        return;
+    }
+
+    state->mqtt_state = MQTT_STATE_RESOLVING;
+    err_t err = dns_gethostbyname(MQTT_SERVER, &state->mqtt_server_address, dns_found, state);
+    if (err == ERR_OK)
+    {
+        start_client(state);
+    }
+    else if (err != ERR_INPROGRESS)
+    { // ERR_INPROGRESS means expect a callback
+        ERROR_printf("dns request failed %d\n", err);
+        schedule_reconnect(state);
     }
 }
 
@@ -672,22 +1694,37 @@ static void start_client(MQTT_CLIENT_DATA_T *state)
     INFO_printf("Warning: Not using TLS\n");
 #endif
 
-    state->mqtt_client_inst = mqtt_client_new();
+    // A mesma instância é reaproveitada nas reconexões
     if (!state->mqtt_client_inst)
     {
-        panic("MQTT client instance creation error");
+        state->mqtt_client_inst = mqtt_client_new();
+        if (!state->mqtt_client_inst)
+        {
+            panic("MQTT client instance creation error");
+        }
+        publish_queue_init(&state->publish_queue, state->mqtt_client_inst, publish_slot_freed, state);
     }
     INFO_printf("IP address of this device %s\n", ipaddr_ntoa(&(netif_list->ip_addr)));
     INFO_printf("Connecting to mqtt server at %s\n", ipaddr_ntoa(&state->mqtt_server_address));
 
     cyw43_arch_lwip_begin();
+    state->mqtt_state = MQTT_STATE_CONNECTING;
+    state->connect_started = get_absolute_time();
+    state->tls_resume_offered = false;
     if (mqtt_client_connect(state->mqtt_client_inst, &state->mqtt_server_address, port, mqtt_connection_cb, state, &state->mqtt_client_info) != ERR_OK)
     {
-        panic("MQTT broker connection error");
+        ERROR_printf("MQTT broker connection error\n");
+        schedule_reconnect(state);
+        cyw43_arch_lwip_end();
+        return;
     }
 #if LWIP_ALTCP && LWIP_ALTCP_TLS
     // This is important for MBEDTLS_SSL_SERVER_NAME_INDICATION
     mbedtls_ssl_set_hostname(altcp_tls_context(state->mqtt_client_inst->conn), MQTT_SERVER);
+
+    // Retoma a sessão anterior: o handshake começa só quando o TCP conectar, então ainda dá tempo
+    if (tls_session_valid)
+        state->tls_resume_offered = altcp_tls_set_session(state->mqtt_client_inst->conn, tls_session) == ERR_OK;
 #endif
     mqtt_set_inpub_callback(state->mqtt_client_inst, mqtt_incoming_publish_cb, mqtt_incoming_data_cb, state);
     cyw43_arch_lwip_end();
@@ -704,6 +1741,7 @@ static void dns_found(const char *hostname, const ip_addr_t *ipaddr, void *arg)
     }
     else
     {
-        panic("dns request failed");
+        ERROR_printf("dns request failed\n");
+        schedule_reconnect(state);
     }
 }
\ No newline at end of file
@@ -0,0 +1,31 @@
+#ifndef PARKING_LAYOUT_H
+#define PARKING_LAYOUT_H
+
+#include "lib/ws2812b/ws2812b.h"
+
+// Cada painel 5x5 mostra 4 vagas, uma em cada canto, como um bloco de 2x2 LEDs.
+#define PARKING_LOTS_PER_PANEL 4
+#define PARKING_LEDS_PER_LOT 4
+#define PARKING_LED_LOTS (PARKING_LOTS_PER_PANEL * LED_PANEL_COUNT) // Vagas que cabem na cadeia de LEDs
+
+// Origem (linha, coluna) do bloco de cada vaga dentro do painel
+#define PARKING_SLOT_ROW(slot) ((slot) < 2 ? LED_PANEL_ROWS - 2 : 0)
+#define PARKING_SLOT_COL(slot) (((slot) & 1) ? 0 : LED_PANEL_COLS - 2)
+
+#define PARKING_LOT_LEDS(panel, slot)                                                                   \
+    {                                                                                                   \
+        WS2812B_LED_INDEX(panel, PARKING_SLOT_ROW(slot), PARKING_SLOT_COL(slot)),                       \
+        WS2812B_LED_INDEX(panel, PARKING_SLOT_ROW(slot), PARKING_SLOT_COL(slot) + 1),                   \
+        WS2812B_LED_INDEX(panel, PARKING_SLOT_ROW(slot) + 1, PARKING_SLOT_COL(slot)),                   \
+        WS2812B_LED_INDEX(panel, PARKING_SLOT_ROW(slot) + 1, PARKING_SLOT_COL(slot) + 1),               \
+    },
+
+#define PARKING_PANEL_LEDS(panel) \
+    PARKING_LOT_LEDS(panel, 0) PARKING_LOT_LEDS(panel, 1) PARKING_LOT_LEDS(panel, 2) PARKING_LOT_LEDS(panel, 3)
+
+// Tabela vaga -> LEDs gerada em tempo de compilação (fica em flash).
+// Para 1 painel: {15, 16, 23, 24}, {18, 19, 20, 21}, {3, 4, 5, 6}, {0, 1, 8, 9} (ordem interna pode variar).
+static const uint16_t parking_lot_leds[PARKING_LED_LOTS][PARKING_LEDS_PER_LOT] = {
+    WS2812B_REPEAT(LED_PANEL_COUNT, PARKING_PANEL_LEDS)};
+
+#endif // PARKING_LAYOUT_H
@@ -0,0 +1,28 @@
+#ifndef TRACE_IDS_H
+#define TRACE_IDS_H
+
+// Ids dos eventos do trace (lib/trace/trace.h). tools/trace_decode.py lê os nomes e os comentários
+// deste arquivo; novos ids entram no fim para dumps antigos continuarem legíveis
+typedef enum
+{
+    TRACE_LOOP_WAKE,          // Loop principal acordou
+    TRACE_GPIO_IRQ,           // arg0 = GPIO, arg1 = eventos
+    TRACE_BUTTON,             // arg0 = GPIO, arg1 = 1 se passou pelo debounce
+    TRACE_LOT_STATUS,         // arg0 = vaga, arg1 = novo status
+    TRACE_OUTPUTS_BEGIN,      // update_outputs
+    TRACE_OUTPUTS_END,        // arg0 = vagas livres
+    TRACE_LED_MATRIX_WRITE,   // Quadro da matriz enviado
+    TRACE_DISPLAY_SEND,       // arg0 = 1 se a transferência começou, 0 se ficou para depois
+    TRACE_DISPLAY_DONE,       // arg0 = 1 se a transferência do display terminou, 0 se foi abortada
+    TRACE_BUZZER_TONE,        // arg0 = vaga, arg1 = frequência em Hz
+    TRACE_COALESCE_FLUSH,     // Fim da janela de agrupamento
+    TRACE_PUBLISH_BEGIN,      // publish_parking_status
+    TRACE_PUBLISH_END,        // arg0 = mensagens enviadas
+    TRACE_PUBLISH_ACK,        // arg0 = vaga, arg1 = erro
+    TRACE_MQTT_MESSAGE,       // arg0 = rota (0xFFFF sem rota), arg1 = tamanho
+    TRACE_MQTT_CONNECTION,    // arg1 = status da conexão
+    TRACE_RESERVATION_EXPIRED, // arg0 = vaga
+    TRACE_HEARTBEAT,          // arg0 = vagas livres
+} trace_id_t;
+
+#endif // TRACE_IDS_H
@@ -0,0 +1,117 @@
+#!/usr/bin/env python3
+"""Decodifica o dump do trace publicado em /trace e mostra a linha do tempo.
+
+Cada linha da entrada é o payload de uma mensagem em hexadecimal, como sai de
+    mosquitto_sub -h <broker> -t /trace -F %x > trace.hex
+(ou de ./parking_sim --trace trace.hex). O dump é pedido publicando qualquer valor em /trace/dump.
+Os nomes dos eventos vêm de src/trace_ids.h.
+"""
+
+import argparse
+import os
+import re
+import struct
+import sys
+
+DUMP_FORMAT = 1
+HEADER = struct.Struct(">BHHHI")  # formato, eventos no dump, posição, eventos na parte, sobrescritos
+EVENT = struct.Struct(">IHHI")    # instante em us, id, arg0, arg1
+
+DEFAULT_IDS = os.path.join(os.path.dirname(os.path.abspath(__file__)), "..", "src", "trace_ids.h")
+
+
+def load_ids(path):
+    """Lê o enum de trace_ids.h: nome e comentário de cada id, na ordem."""
+    names = {}
+    value = 0
+    with open(path, encoding="utf-8") as f:
+        for line in f:
+            match = re.match(r"\s*TRACE_(\w+)\s*(?:=\s*(\d+))?\s*,\s*(?://\s*(.*))?", line)
+            if not match:
+                continue
+            if match.group(2):
+                value = int(match.group(2))
+            names[value] = (match.group(1).lower(), (match.group(3) or "").strip())
+            value += 1
+    return names
+
+
+def read_dumps(lines):
+    """Junta as partes de cada dump; um dump novo começa na parte com posição 0."""
+    dumps = []
+    current = None
+    for number, line in enumerate(lines, 1):
+        line = line.strip()
+        if not line:
+            continue
+        try:
+            payload = bytes.fromhex(line)
+        except ValueError:
+            sys.exit(f"linha {number}: não é hexadecimal")
+        if len(payload) < HEADER.size:
+            sys.exit(f"linha {number}: parte menor que o cabeçalho")
+
+        fmt, total, offset, count, overwritten = HEADER.unpack_from(payload)
+        if fmt != DUMP_FORMAT:
+            sys.exit(f"linha {number}: formato {fmt} desconhecido")
+        if len(payload) != HEADER.size + count * EVENT.size:
+            sys.exit(f"linha {number}: tamanho {len(payload)} não confere com {count} eventos")
+
+        if offset == 0 or current is None:
+            current = {"total": total, "overwritten": overwritten, "events": {}}
+            dumps.append(current)
+        for i in range(count):
+            current["events"][offset + i] = EVENT.unpack_from(payload, HEADER.size + i * EVENT.size)
+    return dumps
+
+
+def render(dump, names, gap_ms, out):
+    events = [dump["events"][i] for i in sorted(dump["events"])]
+    missing = dump["total"] - len(events)
+    out.write(f"# {len(events)} eventos ({dump['overwritten']} sobrescritos antes do dump"
+              f"{f', {missing} partes perdidas' if missing else ''})\n")
+    if not events:
+        return
+
+    out.write(f"{'tempo_ms':>12} {'delta_us':>10}  {'evento':<22} {'arg0':>6} {'arg1':>10}\n")
+    base = events[0][0]
+    epoch = 0
+    previous = None
+    for timestamp, event_id, arg0, arg1 in events:
+        # time_us_32 dá a volta a cada ~71 minutos
+        if previous is not None and timestamp + epoch < previous - (1 << 31):
+            epoch += 1 << 32
+        now = timestamp + epoch
+        delta = 0 if previous is None else now - previous
+        if gap_ms and previous is not None and delta >= gap_ms * 1000:
+            out.write(f"{'':>12} {'':>10}  --- {delta / 1000:.1f} ms sem eventos ---\n")
+
+        name, _ = names.get(event_id, (f"id_{event_id}", ""))
+        out.write(f"{(now - base) / 1000:12.3f} {delta:10d}  {name:<22} {arg0:6d} {arg1:10d}\n")
+        previous = now
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("input", nargs="?", help="arquivo com um payload hexadecimal por linha (padrão: stdin)")
+    parser.add_argument("--ids", default=DEFAULT_IDS, help="cabeçalho com o enum dos ids (padrão: src/trace_ids.h)")
+    parser.add_argument("--gap-ms", type=float, default=50, help="destaca intervalos sem eventos a partir disso (0 desliga)")
+    parser.add_argument("--legend", action="store_true", help="lista os eventos e o significado dos argumentos")
+    args = parser.parse_args()
+
+    names = load_ids(args.ids)
+    if args.legend:
+        for event_id, (name, comment) in sorted(names.items()):
+            print(f"{event_id:3d} {name:<22} {comment}")
+        return
+
+    with (open(args.input, encoding="ascii") if args.input else sys.stdin) as f:
+        dumps = read_dumps(f)
+    if not dumps:
+        sys.exit("nenhum dump na entrada")
+    for dump in dumps:
+        render(dump, names, args.gap_ms, sys.stdout)
+
+
+if __name__ == "__main__":
+    main()